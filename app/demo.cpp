@@ -56,19 +56,19 @@ void demo_hierarchy_editor()
         ImGui::PushID(widget);
         bool node_open;
 
-        if (widget->GetLayout()->GetChildren().empty())
+        auto layout = widget->FindLayout();
+        if (!layout || layout->GetChildren().empty())
         {
             ImGui::Text(widget->GetLabel().c_str());
             ImGui::PopID();
             return;
         }
 
-        std::string type = widget->GetLayout()->GetLayoutType() == LayoutType::Horizontal ? "Horizontal" : "Vertical";
+        std::string type = layout->GetLayoutType() == LayoutType::Horizontal ? "Horizontal" : "Vertical";
         node_open = ImGui::TreeNode(widget, std::format("{} ({})", widget->GetLabel(), type).c_str());
 
         if (node_open)
         {
-            auto layout = widget->GetLayout();
             if (!layout->GetChildren().empty())
             {
                 // std::string type = layout->GetLayoutType() == LayoutType::Horizontal ? "Horizontal" : "Vertical";
@@ -116,6 +116,7 @@ void demo_theme_editor()
         });
 
         std::string last;
+        bool changed = false;
         auto& themeMap = settings.GetSection(theme);
         for (auto& id : themeNames)
         {
@@ -135,6 +136,7 @@ void demo_theme_editor()
                 if (ImGui::ColorEdit4(name.c_str(), &v[0]))
                 {
                     val.f4 = v;
+                    changed = true;
                 }
             }
             else if (prefix == "b_")
@@ -143,6 +145,7 @@ void demo_theme_editor()
                 if (ImGui::Checkbox(name.c_str(), &v))
                 {
                     val.b = v;
+                    changed = true;
                 }
             }
             else if (prefix == "s_")
@@ -151,20 +154,26 @@ void demo_theme_editor()
                 switch (val.type)
                 {
                 case SettingType::Float:
-                    ImGui::DragFloat(name.c_str(), &val.f);
+                    changed |= ImGui::DragFloat(name.c_str(), &val.f);
                     break;
                 case SettingType::Vec2f:
-                    ImGui::DragFloat2(name.c_str(), &val.f);
+                    changed |= ImGui::DragFloat2(name.c_str(), &val.f);
                     break;
                 case SettingType::Vec3f:
-                    ImGui::DragFloat3(name.c_str(), &val.f);
+                    changed |= ImGui::DragFloat3(name.c_str(), &val.f);
                     break;
                 case SettingType::Vec4f:
-                    ImGui::DragFloat4(name.c_str(), &val.f);
+                    changed |= ImGui::DragFloat4(name.c_str(), &val.f);
                     break;
                 }
             }
         }
+
+        // The canvas caches widget draw commands, so it needs to know the theme moved
+        if (changed)
+        {
+            spCanvas->InvalidateDrawCache();
+        }
     }
 }
 
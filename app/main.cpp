@@ -13,6 +13,7 @@
 
 #include <config_nodegraph_app.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <format>
 
@@ -50,6 +51,10 @@ static ImGui_ImplVulkanH_Window g_MainWindowData;
 static uint32_t g_MinImageCount = 2;
 static bool g_SwapChainRebuild = false;
 
+// Idle throttling; after an event ImGui gets a few frames to settle, then the loop sleeps until the next one
+static const int g_ActiveFramesAfterEvent = 3;
+static const int g_IdleWaitMs = 250;
+
 std::shared_ptr<NodeGraph::VulkanImGuiTexture> g_pFontTexture;
 
 namespace Zest {
@@ -567,8 +572,16 @@ int WinMain(int, char**)
     // Main loop
     bool done = false;
     bool demo_init = true;
+    int activeFrames = g_ActiveFramesAfterEvent;
     while (!done)
     {
+        // Nothing has changed, so rather than drawing the same frame again, wait for input.
+        // The timeout still lets anything driven from outside (audio device lists, etc.) refresh now and then.
+        if (activeFrames == 0)
+        {
+            SDL_WaitEventTimeout(nullptr, g_IdleWaitMs);
+        }
+
         // Poll and handle events (inputs, window resize, etc.)
         // You can read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
@@ -577,6 +590,7 @@ int WinMain(int, char**)
         SDL_Event event;
         while (SDL_PollEvent(&event))
         {
+            activeFrames = g_ActiveFramesAfterEvent;
             ImGui_ImplSDL3_ProcessEvent(&event);
             if (event.type == SDL_EVENT_QUIT)
                 done = true;
@@ -628,7 +642,7 @@ int WinMain(int, char**)
             auto& in = pCanvas->GetInputState();
             ImGui::Begin("Debug");
             ImGui::Text("%d capture", in.m_pMouseCapture);
-            ImGui::Text("%d tips", TipTimer::ActiveTips.size());
+            ImGui::Text("%d tips", int(pCanvas->GetTipScheduler().GetActiveCount()));
             ImGui::End();
         }
 
@@ -652,6 +666,13 @@ int WinMain(int, char**)
         // Present Main Platform Window
         if (!main_is_minimized)
             FramePresent(wd);
+
+        // The canvas keeps the loop running while it is animating or has changes to show
+        activeFrames = std::max(activeFrames - 1, 0);
+        if (demo_get_canvas() && demo_get_canvas()->NeedsRedraw())
+        {
+            activeFrames = std::max(activeFrames, 1);
+        }
     }
 
     // Cleanup
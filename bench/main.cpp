@@ -0,0 +1,360 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <zest/settings/settings.h>
+
+#include <nodegraph/canvas.h>
+#include <nodegraph/canvas_null.h>
+#include <nodegraph/canvas_recorder.h>
+#include <nodegraph/node_store.h>
+#include <nodegraph/theme.h>
+#include <nodegraph/widgets/layout.h>
+#include <nodegraph/widgets/node.h>
+#include <nodegraph/widgets/widget_knob.h>
+#include <nodegraph/widgets/widget_slider.h>
+#include <nodegraph/widgets/widget_socket.h>
+
+#include <config_nodegraph_app.h>
+
+// Front end frame cost, measured against CanvasNull so that no backend work is included.
+// Usage: NodeGraph_Bench [nodes] [frames] [threads]
+//        NodeGraph_Bench --trace <file> [loops]
+//        NodeGraph_Bench --store [nodes] [frames]
+
+using namespace NodeGraph;
+namespace fs = std::filesystem;
+
+namespace {
+
+const glm::vec2 NodeSize = glm::vec2(400.0f, 240.0f);
+const float NodeSpacing = 60.0f;
+const glm::vec2 ScreenSize = glm::vec2(1920.0f, 1080.0f);
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Graph
+{
+    std::vector<std::shared_ptr<Node>> nodes;
+    std::vector<CableDesc> cables;
+};
+
+// The same shape of node as the oscillator in the demo, minus the audio
+std::shared_ptr<Node> build_node(Canvas& canvas, int index, const glm::vec2& pos)
+{
+    auto spNode = std::make_shared<Node>("Node " + std::to_string(index));
+    spNode->SetRect(NRectf(pos.x, pos.y, NodeSize.x, NodeSize.y));
+    canvas.GetRootLayout()->AddChild(spNode);
+
+    auto spRootLayout = std::make_shared<Layout>(LayoutType::Vertical);
+    spNode->SetLayout(spRootLayout);
+
+    SliderValue sliderVal;
+    sliderVal.step = 0.1f;
+    sliderVal.value = 0.5f;
+    sliderVal.units = "Hz";
+
+    for (int row = 0; row < 2; row++)
+    {
+        auto spHorzLayout = std::make_shared<Layout>(LayoutType::Horizontal);
+        spHorzLayout->SetContentsMargins(glm::vec4(0.0f));
+        spHorzLayout->SetConstraints(glm::uvec2(LayoutConstraint::Expanding, LayoutConstraint::Preferred));
+        spHorzLayout->SetRect(NRectf(0.0f, 0.0f, 0.0f, 50.0f));
+        spRootLayout->AddChild(spHorzLayout);
+
+        auto spSocket = std::make_shared<Socket>("In", SocketType::Left);
+        spSocket->SetRect(NRectf(0.0f, 0.0f, 30.0f, 30.0f));
+        spSocket->SetConstraints(glm::uvec2(LayoutConstraint::Preferred, LayoutConstraint::Expanding));
+        spHorzLayout->AddChild(spSocket);
+
+        spHorzLayout->AddChild(std::make_shared<Slider>("Amp", sliderVal));
+
+        auto spKnob = std::make_shared<Knob>("Tone");
+        spKnob->SetRect(NRectf(0.0f, 0.0f, 50.0f, 50.0f));
+        spHorzLayout->AddChild(spKnob);
+
+        spHorzLayout->AddChild(std::make_shared<Slider>("Freq", sliderVal));
+
+        spSocket = std::make_shared<Socket>("Out", SocketType::Right);
+        spSocket->SetRect(NRectf(0.0f, 0.0f, 30.0f, 30.0f));
+        spSocket->SetConstraints(glm::uvec2(LayoutConstraint::Preferred, LayoutConstraint::Expanding));
+        spHorzLayout->AddChild(spSocket);
+    }
+    return spNode;
+}
+
+// A square grid of nodes, each one cabled to its right hand neighbour
+Graph build_graph(Canvas& canvas, int nodeCount)
+{
+    Graph graph;
+    auto columns = std::max(1, int(std::ceil(std::sqrt(float(nodeCount)))));
+    auto stride = NodeSize + NodeSpacing;
+    for (int i = 0; i < nodeCount; i++)
+    {
+        auto pos = glm::vec2(float(i % columns), float(i / columns)) * stride;
+        graph.nodes.push_back(build_node(canvas, i, pos));
+
+        if ((i % columns) != 0)
+        {
+            CableDesc cable;
+            cable.from = pos - glm::vec2(NodeSpacing, -NodeSize.y * 0.5f);
+            cable.to = pos + glm::vec2(0.0f, NodeSize.y * 0.5f);
+            cable.fromTangent = glm::vec2(NodeSpacing * 0.5f, 0.0f);
+            cable.toTangent = glm::vec2(-NodeSpacing * 0.5f, 0.0f);
+            cable.width = 2.0f;
+            graph.cables.push_back(cable);
+        }
+    }
+    return graph;
+}
+
+double elapsed_ms(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const char* pszName, double totalMs, int frames, const CanvasNull& canvas)
+{
+    auto& counters = canvas.GetCounters();
+    printf("%-28s %9.3f ms/frame  %10llu calls/frame  %8llu text/frame  %10llu points/frame\n",
+        pszName,
+        totalMs / frames,
+        (unsigned long long)(counters.TotalCalls() / frames),
+        (unsigned long long)(counters.calls[size_t(DrawCmdType::Text)] / frames),
+        (unsigned long long)(counters.polylinePoints / frames));
+}
+
+void draw_frame(CanvasNull& canvas, const Graph& graph)
+{
+    canvas.Begin(glm::vec4(0.2f, 0.2f, 0.2f, 1.0f));
+    canvas.DrawGrid(100.0f);
+    canvas.DrawCables(graph.cables);
+    canvas.Draw();
+    canvas.End();
+}
+
+int run_graph(int nodeCount, int frames, int threads)
+{
+    CanvasNull canvas(ScreenSize, 0.5f, glm::vec2(0.05f, 10.0f));
+    canvas.SetRecordThreads(uint32_t(threads));
+    auto graph = build_graph(canvas, nodeCount);
+    canvas.SetWorldAtCenter(glm::vec2(0.0f));
+
+    printf("%d nodes, %zu cables, %d frames, %u record threads\n", nodeCount, graph.cables.size(), frames, canvas.GetRecordThreads());
+
+    // The first frame lays out and records everything
+    canvas.ResetCounters();
+    auto start = Clock::now();
+    draw_frame(canvas, graph);
+    report("first frame", elapsed_ms(start), 1, canvas);
+
+    // Nothing changes; every widget replays its cached commands
+    canvas.ResetCounters();
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        draw_frame(canvas, graph);
+    }
+    report("static view", elapsed_ms(start), frames, canvas);
+
+    // Panning; culling changes and view dependent recordings are redone
+    canvas.ResetCounters();
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        canvas.SetWorldAtCenter(glm::vec2(float(i) * 20.0f, float(i) * 10.0f));
+        draw_frame(canvas, graph);
+    }
+    report("panning", elapsed_ms(start), frames, canvas);
+
+    // Zooming; every recording is thrown away each frame
+    canvas.ResetCounters();
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        canvas.SetWorldView(canvas.GetWorldOrigin(), 0.25f + 0.5f * float(i % 16) / 16.0f);
+        draw_frame(canvas, graph);
+    }
+    report("zooming", elapsed_ms(start), frames, canvas);
+
+    // Hover hit testing, with the mouse swept across the screen
+    auto& input = canvas.GetInputState();
+    for (uint32_t i = 0; i < MOUSE_MAX; i++)
+    {
+        input.buttonClicked[i] = false;
+        input.buttonReleased[i] = false;
+        input.buttonDown[i] = false;
+    }
+    input.wheelDelta = 0.0f;
+    input.mousePos = glm::vec2(0.0f);
+
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        CanvasInputEvent event;
+        event.time = double(i) / 60.0;
+        event.mousePos = glm::vec2(float((i * 37) % int(ScreenSize.x)), float((i * 23) % int(ScreenSize.y)));
+        canvas.PushInput(event);
+        canvas.HandleMouse();
+    }
+    printf("%-28s %9.3f ms/frame\n", "mouse move", elapsed_ms(start) / frames);
+    return 0;
+}
+
+int run_trace(const char* pszPath, int loops)
+{
+    std::ifstream in(pszPath, std::ios::binary);
+    if (!in || !trace_read_header(in))
+    {
+        printf("Not a draw trace: %s\n", pszPath);
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<TraceFrame>> frames;
+    for (;;)
+    {
+        auto spFrame = std::make_unique<TraceFrame>();
+        if (!trace_read_frame(in, *spFrame))
+        {
+            break;
+        }
+        frames.push_back(std::move(spFrame));
+    }
+
+    if (frames.empty())
+    {
+        printf("No frames in trace: %s\n", pszPath);
+        return 1;
+    }
+
+    printf("%zu frames, %d loops\n", frames.size(), loops);
+
+    CanvasNull canvas;
+    auto start = Clock::now();
+    for (int loop = 0; loop < loops; loop++)
+    {
+        for (auto& spFrame : frames)
+        {
+            trace_replay_frame(canvas, *spFrame);
+        }
+    }
+    report("trace replay", elapsed_ms(start), int(frames.size()) * loops, canvas);
+    return 0;
+}
+
+// The same grid of nodes in a NodeStore; each node with the rects of the two rows of controls
+// in build_node as children
+int run_store(int nodeCount, int frames)
+{
+    NodeStore store;
+    std::vector<NodeHandle> nodes;
+    auto columns = std::max(1, int(std::ceil(std::sqrt(float(nodeCount)))));
+    auto stride = NodeSize + NodeSpacing;
+
+    auto start = Clock::now();
+    for (int i = 0; i < nodeCount; i++)
+    {
+        auto pos = glm::vec2(float(i % columns), float(i / columns)) * stride;
+        auto node = store.Add(NRectf(pos.x, pos.y, NodeSize.x, NodeSize.y));
+        nodes.push_back(node);
+        for (int row = 0; row < 2; row++)
+        {
+            auto rowPos = pos + glm::vec2(10.0f, 40.0f + row * 56.0f);
+            auto rowNode = store.Add(NRectf(rowPos.x, rowPos.y, NodeSize.x - 20.0f, 50.0f), node);
+            for (int col = 0; col < 5; col++)
+            {
+                store.Add(NRectf(rowPos.x + col * 76.0f, rowPos.y, 70.0f, 50.0f), rowNode);
+            }
+        }
+    }
+    store.GetPreOrder();
+    printf("%d nodes, %zu entries\n", nodeCount, store.Size());
+    printf("%-28s %9.3f ms\n", "build", elapsed_ms(start));
+
+    std::vector<NodeHandle> visible;
+    size_t visibleCount = 0;
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        auto origin = glm::vec2(float(i) * 20.0f, float(i) * 10.0f);
+        store.Cull(NRectf(origin.x, origin.y, ScreenSize.x * 2.0f, ScreenSize.y * 2.0f), visible);
+        visibleCount += visible.size();
+    }
+    printf("%-28s %9.3f ms/frame  %10zu visible/frame\n", "cull", elapsed_ms(start) / frames, visibleCount / frames);
+
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        store.HitTest(glm::vec2(float((i * 37) % int(ScreenSize.x)), float((i * 23) % int(ScreenSize.y))));
+    }
+    printf("%-28s %9.3f ms/frame\n", "hit test", elapsed_ms(start) / frames);
+
+    // Dragging a selection of every tenth node
+    std::vector<NodeHandle> selection;
+    for (size_t i = 0; i < nodes.size(); i += 10)
+    {
+        selection.push_back(nodes[i]);
+    }
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        store.Move(selection, glm::vec2(1.0f, 0.5f));
+    }
+    printf("%-28s %9.3f ms/frame  %10zu nodes\n", "move selection", elapsed_ms(start) / frames, selection.size());
+
+    // Reordering rebuilds the flattened hierarchy on the next query
+    start = Clock::now();
+    for (int i = 0; i < frames; i++)
+    {
+        store.Raise(nodes[(i * 7919) % nodes.size()]);
+        store.GetPreOrder();
+    }
+    printf("%-28s %9.3f ms/frame\n", "raise", elapsed_ms(start) / frames);
+
+    std::stringstream stream;
+    start = Clock::now();
+    store.Write(stream);
+    printf("%-28s %9.3f ms  %10zu bytes\n", "write", elapsed_ms(start), size_t(stream.tellp()));
+
+    NodeStore loaded;
+    start = Clock::now();
+    if (!loaded.Read(stream) || loaded.Size() != store.Size())
+    {
+        printf("Store read failed\n");
+        return 1;
+    }
+    printf("%-28s %9.3f ms\n", "read", elapsed_ms(start));
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Zest::GlobalSettingsManager::Instance().Load(fs::path(NODEGRAPH_ROOT) / "settings.toml");
+
+    if (argc > 2 && std::string(argv[1]) == "--trace")
+    {
+        return run_trace(argv[2], argc > 3 ? std::max(1, atoi(argv[3])) : 10);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--store")
+    {
+        auto nodeCount = argc > 2 ? std::max(1, atoi(argv[2])) : 100000;
+        auto frames = argc > 3 ? std::max(1, atoi(argv[3])) : 100;
+        return run_store(nodeCount, frames);
+    }
+
+    auto nodeCount = argc > 1 ? std::max(1, atoi(argv[1])) : 1000;
+    auto frames = argc > 2 ? std::max(1, atoi(argv[2])) : 100;
+    auto threads = argc > 3 ? std::max(1, atoi(argv[3])) : 1;
+    return run_graph(nodeCount, frames, threads);
+}
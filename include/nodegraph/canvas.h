@@ -3,17 +3,25 @@
 #include <cassert>
 #include <chrono>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <vector>
 
 #include <zest/math/math_utils.h>
 #include <zest/time/timer.h>
 
+#include <nodegraph/frame_arena.h>
+#include <nodegraph/theme_cache.h>
 #include <nodegraph/widgets/widget.h>
 
 namespace NodeGraph {
 
 struct FontContext;
 struct IFontTexture;
+class DrawList;
+class SpatialGrid;
+class RecordWorker;
+class WorkerPool;
 
 enum class LineCap
 {
@@ -43,6 +51,35 @@ enum class CaptureState
     Parameter // Tweaking a parameter
 };
 
+namespace InputModifiers {
+enum
+{
+    None = 0,
+    Ctrl = (1 << 0),
+    Shift = (1 << 1),
+    Alt = (1 << 2)
+};
+}
+
+enum class CanvasInputType
+{
+    Move,
+    ButtonDown,
+    ButtonUp,
+    Wheel
+};
+
+// A raw event from the host, SDL, ImGui or a test; the position is in pixels relative to the canvas
+struct CanvasInputEvent
+{
+    CanvasInputType type = CanvasInputType::Move;
+    double time = 0.0; // Seconds, on any clock that only goes forwards
+    glm::vec2 mousePos = glm::vec2(0.0f);
+    uint32_t button = MOUSE_LEFT;
+    float wheel = 0.0f;
+    uint32_t modifiers = InputModifiers::None;
+};
+
 // Represents the current interaction state with the canvas; used for
 // tracking mouse manipulation
 struct CanvasInputState
@@ -64,12 +101,33 @@ struct CanvasInputState
     bool slowDrag = false; // Dragging slowly
     float wheelDelta;
     bool canCapture = false;
+    double time = 0.0; // Of the event being handled
     CaptureState captureState = CaptureState::None;
     Widget* m_pMouseCapture = nullptr;
 };
 
 using Zest::NRectf;
 
+// A bezier connection between two points; the tangents are offsets from the end points to their control points
+struct CableDesc
+{
+    glm::vec2 from;
+    glm::vec2 fromTangent;
+    glm::vec2 to;
+    glm::vec2 toTangent;
+    glm::vec4 color = glm::vec4(1.0f);
+    float width = 1.0f;
+};
+
+// One line in a shared stream of polyline points
+struct PolylineRun
+{
+    uint32_t offset = 0; // First point
+    uint32_t count = 0;
+    glm::vec4 color;
+    float width = 1.0f;
+};
+
 class Canvas
 {
 public:
@@ -86,51 +144,106 @@ public:
     virtual float WorldSizeToPixelSize(float size) const;
     virtual glm::vec2 WorldSizeToPixelSize(const glm::vec2& size) const;
 
+    // WorldToPixels for a whole stream of points, plus a pixel offset; backends use it before handing points on in bulk
+    void WorldPointsToPixels(std::span<const glm::vec2> points, glm::vec2* pPixels, const glm::vec2& pixelOffset = glm::vec2(0.0f)) const;
+
     virtual float GetWorldScale() const;
     virtual void SetWorldAtCenter(const glm::vec2& world);
 
+    // The whole view; world origin at the top left pixel, and pixels per world unit
+    glm::vec2 GetWorldOrigin() const;
+    void SetWorldView(const glm::vec2& worldOrigin, float worldScale);
+
     // Mouse state
     virtual glm::vec2 GetWorldMousePos() const;
     virtual void HandleMouse();
     CanvasInputState& GetInputState();
 
+    // Queue input for the next HandleMouse, which handles each event in order with the state as it was
+    // at that event. Consecutive moves are merged, so a fast mouse can't flood it.
+    void PushInput(const CanvasInputEvent& event);
+
     // Pixel region
     void SetPixelRegionSize(const glm::vec2& sz);
     glm::vec2 GetPixelRegionSize() const;
 
+    // Visibility culling against the world region on screen
+    NRectf GetVisibleWorldRect() const;
+    bool IsVisible(const NRectf& worldRect);
+
+    // Level of detail; is something of this world size at least this many pixels on screen
+    bool IsDetailVisible(float worldSize, float minPixelSize) const;
+
     // Base class rendering
+    // The grid is drawn at multiples of worldStep, fading the finer levels in and out with zoom
     virtual void DrawGrid(float worldStep);
     virtual void DrawCubicBezier(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4, const glm::vec4& color, float width = 1.0f);
     virtual void DrawLine(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color, float width);
 
+    // Cull, tessellate and draw a whole set of cables in one batch
+    virtual void DrawCables(std::span<const CableDesc> cables);
+
     // Does this implementation support varying gradients (imgui currently does not)
     virtual bool HasGradientVarying() const;
 
-    // Drawing functions; These are all in world space, not pixel space
-    void CubicBezier(std::vector<glm::vec2>& path, float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, float tess_tol, int level);
+    // Drawing functions; These are all in world space, not pixel space.
+    // While a DrawList is being captured they are recorded into it, otherwise they go straight to the backend
+    void CubicBezier(std::vector<glm::vec2>& path, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4, float pixelTolerance);
     virtual void Begin(const glm::vec4& clearColor) = 0;
     virtual void End() = 0;
-    virtual void FilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) = 0;
-    virtual void FilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) = 0;
-    virtual void FillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) = 0;
-    virtual void FillRect(const NRectf& rc, const glm::vec4& color) = 0;
-    virtual void FillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) = 0;
-    virtual void FillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) = 0;
-    virtual void Stroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) = 0;
-    virtual void Arc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) = 0;
-    virtual void SetAA(bool set) = 0;
-    virtual void BeginStroke(const glm::vec2& from, float width, const glm::vec4& color) = 0;
-    virtual void BeginPath(const glm::vec2& from, const glm::vec4& color) = 0;
-    virtual void MoveTo(const glm::vec2& to) = 0;
-    virtual void LineTo(const glm::vec2& to) = 0;
-    virtual void SetLineCap(LineCap cap) = 0;
-    virtual void ClosePath() = 0;
-    virtual void EndPath() = 0;
-    virtual void EndStroke() = 0;
-    virtual void Text(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace = nullptr, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) = 0;
+    void FilledCircle(const glm::vec2& center, float radius, const glm::vec4& color);
+    void FilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor);
+    void FillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color);
+    void FillRect(const NRectf& rc, const glm::vec4& color);
+    void FillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor);
+    void FillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor);
+    void Stroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color);
+    void Arc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle);
+    void SetAA(bool set);
+    void BeginStroke(const glm::vec2& from, float width, const glm::vec4& color);
+    void BeginPath(const glm::vec2& from, const glm::vec4& color);
+    void MoveTo(const glm::vec2& to);
+    void LineTo(const glm::vec2& to);
+    void SetLineCap(LineCap cap);
+    void ClosePath();
+    void EndPath();
+    void EndStroke();
+    void Polyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed = false);
+    void FillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color);
+    void Text(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace = nullptr, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER);
     virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) const = 0;
-    virtual void TextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace = nullptr, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) = 0;
+    void TextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace = nullptr, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER);
+
+    // A rounded rect with a border ring, over a drop shadow offset down and right by shadowSize; the
+    // standard widget background, drawn as a single shape
+    void Slab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor);
+
+    // Record or draw a batch of polylines
+    void SubmitPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs);
+
+    // Draw command capture; the drawing functions record into the list until EndCapture
+    void BeginCapture(DrawList& drawList);
+    void EndCapture();
+    bool IsCapturing() const;
+
+    // Scratch memory that lives until the next Begin; for temporary strings and lists during drawing and input
+    FrameArena& GetFrameArena();
 
+    // The current theme, resolved once into plain fields; re-read after a theme switch or InvalidateDrawCache
+    const ThemeCache& GetTheme();
+
+    // Tip animations; the clock is sampled at the start of each frame and of input handling
+    TipScheduler& GetTipScheduler();
+
+    // Force every widget to re-record its draw commands (theme edits, etc.)
+    void InvalidateDrawCache();
+
+    // Has anything changed since the last Draw; input, the view, dirty widgets or animating tips.
+    // When it hasn't, a host can skip regenerating the canvas and stop presenting frames until it does.
+    bool NeedsRedraw() const;
+    void RequestRedraw();
+
+    void HandleInputState();
     void HandleMouseDown(CanvasInputState& input);
     void HandleMouseUp(CanvasInputState& input);
     void HandleMouseMove(CanvasInputState& input);
@@ -139,15 +252,92 @@ public:
 
     void Draw();
 
+    // Top level widgets that need recording are recorded across this many threads during Draw, then
+    // replayed in z order; 1 records them all on the calling thread. With more, widget Draw functions and
+    // PostDraw callbacks run on worker threads, so anything they read outside of their own widget must
+    // be safe to read concurrently.
+    void SetRecordThreads(uint32_t threadCount);
+    uint32_t GetRecordThreads() const;
+
+protected:
+    // Every backend's Begin calls this first
+    void BeginFrame();
+
+    // Record a top level widget into its draw cache
+    void RecordWidget(Widget* pWidget, const NRectf& visibleRect);
+    void RecordWidgets(const NRectf& visibleRect);
+
+    // Backend implementation of the drawing functions
+    virtual void OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) = 0;
+    virtual void OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) = 0;
+    virtual void OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) = 0;
+    virtual void OnFillRect(const NRectf& rc, const glm::vec4& color) = 0;
+    virtual void OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) = 0;
+    virtual void OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) = 0;
+    virtual void OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) = 0;
+    virtual void OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) = 0;
+    virtual void OnSetAA(bool set) = 0;
+    virtual void OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color) = 0;
+    virtual void OnBeginPath(const glm::vec2& from, const glm::vec4& color) = 0;
+    virtual void OnMoveTo(const glm::vec2& to) = 0;
+    virtual void OnLineTo(const glm::vec2& to) = 0;
+    virtual void OnSetLineCap(LineCap cap) = 0;
+    virtual void OnClosePath() = 0;
+    virtual void OnEndPath() = 0;
+    virtual void OnEndStroke() = 0;
+    virtual void OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed) = 0;
+    virtual void OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color) = 0;
+
+    // Many open polylines sharing one point stream; backends that can batch them should override this
+    virtual void OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs);
+
+    // Defaults to the three overlapping rounded rects; backends that can build it as one mesh should override this
+    virtual void OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor);
+    virtual void OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) = 0;
+    virtual void OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) = 0;
+
 protected:
     glm::vec2 m_pixelSize; // Pixel size on screen of canvas
     glm::vec2 m_worldOrigin = glm::vec2(0.0f); // Origin of the world at the top left pixel
     float m_worldScale = 1.0f;
     glm::vec2 m_worldScaleLimits = glm::vec2(0.1f, 10.0f);
     CanvasInputState m_inputState;
+    std::vector<CanvasInputEvent> m_inputQueue;
+    glm::vec2 m_buttonDownPos[MouseButtons::MOUSE_MAX]; // Pixel position of each button's last press
     std::vector<glm::vec2> pointStorage;
+    std::vector<PolylineRun> m_cableRuns;
+
+    // Grid lines, regenerated only when the view or theme changes
+    std::vector<glm::vec2> m_gridPoints;
+    std::vector<PolylineRun> m_gridRuns;
+    glm::vec2 m_gridOrigin = glm::vec2(0.0f);
+    glm::vec2 m_gridPixelSize = glm::vec2(0.0f);
+    float m_gridScale = 0.0f;
+    float m_gridStep = 0.0f;
+    uint64_t m_gridGeneration = 0;
     std::shared_ptr<FontContext> spFontContext;
     std::shared_ptr<Layout> m_spRootLayout;
+    std::shared_ptr<SpatialGrid> m_spSpatialGrid; // Hit test index over the root layout's children
+    std::vector<Widget*> m_hitCandidates;
+
+    DrawList* m_pCapture = nullptr; // Current capture target
+    uint64_t m_drawCacheGeneration = 1; // Bumped to invalidate all cached widget commands
+    float m_drawCacheScale = 0.0f; // World scale the cached commands were recorded at
+    bool m_captureCulled = false; // Something was culled during the current capture
+    bool m_redrawRequested = true;
+    FrameArena m_frameArena;
+    ThemeCache m_theme;
+    Zest::StringId m_themeId; // Theme the cache was resolved from
+    bool m_themeValid = false;
+    TipScheduler m_tips; // After the root layout, so that it lets go of the tips before they are destroyed
+
+    // Parallel recording
+    friend class RecordWorker;
+    std::vector<Widget*> m_drawWidgets; // Visible top level widgets, back to front
+    std::vector<Widget*> m_recordWidgets; // The ones among them that need recording
+    std::unique_ptr<WorkerPool> m_spRecordPool;
+    std::vector<std::unique_ptr<RecordWorker>> m_recordWorkers; // One per pool worker
+    std::mutex m_textMutex; // Workers measure text through this canvas one at a time
 };
 
 } // namespace NodeGraph
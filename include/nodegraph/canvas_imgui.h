@@ -9,57 +9,63 @@
 namespace NodeGraph
 {
 
+// Queue this frame's ImGui mouse input on the canvas; it is handled by the next HandleMouse.
+// ImGui trickles presses and releases that arrive in the same frame over the following frames,
+// so the events come out in order, each at the position it happened. Presses come first, at the
+// position ImGui saw them, so that drags are measured from there rather than from where the mouse
+// got to by the end of the frame.
 inline CanvasInputState& canvas_imgui_update_state(Canvas& canvas, const glm::vec2& pixelRegionSize, bool forceCanCapture = false)
 {
     auto& state = canvas.GetInputState();
+    auto& io = ImGui::GetIO();
 
-    auto mousePos = (glm::vec2)ImGui::GetIO().MousePos;
     auto windowPos = (glm::vec2)ImGui::GetWindowContentRegionMin() + (glm::vec2)ImGui::GetWindowPos(); 
 
-    state.mousePos = mousePos - windowPos;
-    //glm::vec2(mousePos.x, mousePos.y);
+    io.ConfigWindowsMoveFromTitleBarOnly = true;
+    state.canCapture = io.WantCaptureMouse || forceCanCapture;
 
+    CanvasInputEvent event;
+    event.time = ImGui::GetTime();
+    event.modifiers = (io.KeyCtrl ? InputModifiers::Ctrl : 0) | (io.KeyShift ? InputModifiers::Shift : 0) | (io.KeyAlt ? InputModifiers::Alt : 0);
+
+    auto lastPos = state.mousePos;
     for (uint32_t i = 0; i < MOUSE_MAX; i++)
     {
-        state.buttonClicked[i] = ImGui::GetIO().MouseClicked[i];
-        state.buttonReleased[i] = ImGui::GetIO().MouseReleased[i];
-        state.buttonDown[i] = ImGui::GetIO().MouseDown[i];
-    }
-    ImGui::GetIO().ConfigWindowsMoveFromTitleBarOnly = true;
-    state.canCapture = ImGui::GetIO().WantCaptureMouse || forceCanCapture;
-    state.mouseDelta = ImGui::GetIO().MouseDelta;
-    if (state.buttonDown[0] == 1)
-    {
-        state.dragDelta = ImGui::GetMouseDragDelta(ImGuiMouseButton_Left);
-    }
-    else
-    {
-        state.dragDelta = ImGui::GetMouseDragDelta(ImGuiMouseButton_Right);
+        if (io.MouseClicked[i])
+        {
+            event.type = CanvasInputType::ButtonDown;
+            event.button = i;
+            event.mousePos = (glm::vec2)io.MouseClickedPos[i] - windowPos;
+            canvas.PushInput(event);
+            lastPos = event.mousePos;
+        }
     }
-    state.wheelDelta = ImGui::GetIO().MouseWheel;
 
-    if (ImGui::GetIO().KeyCtrl && state.buttonClicked[0] == 1)
-    {
-        state.slowDrag = true;
-    }
-    else if (state.buttonDown[0] == 0)
+    event.type = CanvasInputType::Move;
+    event.button = MOUSE_LEFT;
+    event.mousePos = (glm::vec2)io.MousePos - windowPos;
+    if (event.mousePos != lastPos)
     {
-        state.slowDrag = false;
+        canvas.PushInput(event);
     }
 
-    state.worldMousePos = canvas.PixelToWorld(state.mousePos);
-    state.worldDragDelta = state.dragDelta / canvas.GetWorldScale(); // Drag delta while mouse button down
-    state.worldMoveDelta = state.mouseDelta / canvas.GetWorldScale(); // Mouse move delta (without drag?)
-    //LOG(DBG, "Move: " << state.worldMoveDelta.x << ", " << state.mouseDelta.x);
-
     for (uint32_t i = 0; i < MOUSE_MAX; i++)
     {
-        if (state.buttonClicked[i])
+        if (io.MouseReleased[i])
         {
-            state.lastWorldMouseClick[i] = state.worldMousePos;
+            event.type = CanvasInputType::ButtonUp;
+            event.button = i;
+            canvas.PushInput(event);
         }
     }
 
+    if (io.MouseWheel != 0.0f)
+    {
+        event.type = CanvasInputType::Wheel;
+        event.wheel = io.MouseWheel;
+        canvas.PushInput(event);
+    }
+
     return state;
 }
 
@@ -75,43 +81,51 @@ public:
 
     virtual void Begin(const glm::vec4& clearColor) override;
     virtual void End() override;
-    virtual void FilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) override;
-    virtual void FilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
-    virtual void FillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) override;
-    virtual void FillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
-    virtual void FillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
-    virtual void FillRect(const NRectf& rc, const glm::vec4& color) override;
-
-    virtual void SetAA(bool set) override;
-    virtual void BeginStroke(const glm::vec2& from, float width, const glm::vec4& color) override;
-    virtual void BeginPath(const glm::vec2& from, const glm::vec4& color) override;
-    virtual void MoveTo(const glm::vec2& to) override;
-    virtual void LineTo(const glm::vec2& to) override;
-    virtual void ClosePath() override;
-    virtual void EndPath() override;
-    virtual void EndStroke() override;
-
-    virtual void Text(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace = nullptr, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) override;
-    virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) const override;
-    virtual void TextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace = nullptr, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) override;
-
-    virtual void Stroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) override;
 
-    virtual void Arc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) override;
-
-    virtual void SetLineCap(LineCap cap) override;
+    virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) const override;
 
     virtual bool HasGradientVarying() const override
     {
         return true;
     }
 
+protected:
+    virtual void OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) override;
+    virtual void OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) override;
+    virtual void OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRect(const NRectf& rc, const glm::vec4& color) override;
+
+    virtual void OnSetAA(bool set) override;
+    virtual void OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color) override;
+    virtual void OnBeginPath(const glm::vec2& from, const glm::vec4& color) override;
+    virtual void OnMoveTo(const glm::vec2& to) override;
+    virtual void OnLineTo(const glm::vec2& to) override;
+    virtual void OnClosePath() override;
+    virtual void OnEndPath() override;
+    virtual void OnEndStroke() override;
+    virtual void OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed) override;
+    virtual void OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color) override;
+    virtual void OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs) override;
+    virtual void OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor) override;
+
+    virtual void OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+    virtual void OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+
+    virtual void OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) override;
+
+    virtual void OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) override;
+
+    virtual void OnSetLineCap(LineCap cap) override;
+
 private:
     glm::vec2 displaySize;
     ImVec2 origin;
     uint32_t m_pathColor;
     float m_pathWidth;
     bool m_closePath = false;
+    std::vector<glm::vec2> m_polylinePoints; // Pixel space; laid out the same as ImVec2
     ImFont* m_pFont = nullptr;
     int m_defaultFont = 0;
     int m_fontIcon = 0;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <nodegraph/canvas.h>
+#include <nodegraph/draw_list.h>
+
+namespace NodeGraph {
+
+struct CanvasNullCounters
+{
+    std::array<uint64_t, DrawCmdTypeCount> calls{}; // Indexed by DrawCmdType
+    uint64_t polylinePoints = 0;
+    uint64_t polylineBatches = 0;
+    uint64_t textBytes = 0;
+    uint64_t textMeasures = 0;
+    uint64_t frames = 0;
+
+    uint64_t TotalCalls() const;
+};
+
+// A backend that draws nothing and only counts what it is asked to do.
+// Timing a frame against it gives the cost of the front end alone; walking the widget tree, layout,
+// theme lookups and recording, without any tessellation or GPU work.
+class CanvasNull : public Canvas
+{
+public:
+    CanvasNull(const glm::vec2& pixelSize = glm::vec2(1920.0f, 1080.0f), float worldScale = 1.0f, const glm::vec2& scaleLimits = glm::vec2(0.1f, 10.0f));
+
+    virtual void Begin(const glm::vec4& clearColor) override;
+    virtual void End() override;
+
+    // A fixed width per character; no font is loaded
+    virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) const override;
+
+    const CanvasNullCounters& GetCounters() const;
+    void ResetCounters();
+
+protected:
+    virtual void OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) override;
+    virtual void OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) override;
+    virtual void OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRect(const NRectf& rc, const glm::vec4& color) override;
+
+    virtual void OnSetAA(bool set) override;
+    virtual void OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color) override;
+    virtual void OnBeginPath(const glm::vec2& from, const glm::vec4& color) override;
+    virtual void OnMoveTo(const glm::vec2& to) override;
+    virtual void OnLineTo(const glm::vec2& to) override;
+    virtual void OnClosePath() override;
+    virtual void OnEndPath() override;
+    virtual void OnEndStroke() override;
+    virtual void OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed) override;
+    virtual void OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color) override;
+    virtual void OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs) override;
+    virtual void OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor) override;
+
+    virtual void OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+    virtual void OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+
+    virtual void OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) override;
+
+    virtual void OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) override;
+
+    virtual void OnSetLineCap(LineCap cap) override;
+
+private:
+    void Count(DrawCmdType type);
+
+private:
+    mutable CanvasNullCounters m_counters;
+};
+
+} // namespace NodeGraph
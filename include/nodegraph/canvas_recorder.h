@@ -0,0 +1,85 @@
+#pragma once
+
+#include <iosfwd>
+
+#include <nodegraph/canvas.h>
+#include <nodegraph/draw_list.h>
+
+namespace NodeGraph {
+
+// One frame of a draw trace; the view it was drawn with, and every primitive in world space
+struct TraceFrame
+{
+    glm::vec2 pixelSize = glm::vec2(0.0f);
+    glm::vec2 worldOrigin = glm::vec2(0.0f);
+    float worldScale = 1.0f;
+    glm::vec4 clearColor = glm::vec4(0.0f);
+    DrawList drawList;
+};
+
+// Trace file; a header, then frames until the end of the stream
+void trace_write_header(std::ostream& out);
+bool trace_read_header(std::istream& in);
+void trace_write_frame(std::ostream& out, const TraceFrame& frame);
+bool trace_read_frame(std::istream& in, TraceFrame& frame);
+
+// Draw a recorded frame on any backend, with the view it was recorded at
+void trace_replay_frame(Canvas& canvas, const TraceFrame& frame);
+
+// Sits in front of another canvas and passes every call through to it, while writing each
+// Begin/End frame to a binary trace. The trace can then be replayed on any backend to benchmark
+// it against a real session, without having to reproduce the interaction.
+class CanvasRecorder : public Canvas
+{
+public:
+    CanvasRecorder(Canvas& target, std::ostream& trace);
+
+    virtual void Begin(const glm::vec4& clearColor) override;
+    virtual void End() override;
+
+    virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) const override;
+    virtual bool HasGradientVarying() const override;
+
+    // Traced as their descriptions, so that a replay tessellates them again
+    virtual void DrawCables(std::span<const CableDesc> cables) override;
+
+    uint32_t GetFrameCount() const;
+
+protected:
+    virtual void OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) override;
+    virtual void OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) override;
+    virtual void OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRect(const NRectf& rc, const glm::vec4& color) override;
+
+    virtual void OnSetAA(bool set) override;
+    virtual void OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color) override;
+    virtual void OnBeginPath(const glm::vec2& from, const glm::vec4& color) override;
+    virtual void OnMoveTo(const glm::vec2& to) override;
+    virtual void OnLineTo(const glm::vec2& to) override;
+    virtual void OnClosePath() override;
+    virtual void OnEndPath() override;
+    virtual void OnEndStroke() override;
+    virtual void OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed) override;
+    virtual void OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color) override;
+    virtual void OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs) override;
+    virtual void OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor) override;
+
+    virtual void OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+    virtual void OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+
+    virtual void OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) override;
+
+    virtual void OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) override;
+
+    virtual void OnSetLineCap(LineCap cap) override;
+
+private:
+    Canvas& m_target;
+    std::ostream& m_trace;
+    TraceFrame m_frame;
+    uint32_t m_frameCount = 0;
+};
+
+} // namespace NodeGraph
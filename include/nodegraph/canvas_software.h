@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <nodegraph/canvas.h>
+
+namespace NodeGraph {
+
+struct FontVertex;
+
+// A solid color, or a linear gradient between two pixel space points
+struct SoftwarePaint
+{
+    glm::vec4 startColor = glm::vec4(1.0f);
+    glm::vec4 endColor = glm::vec4(1.0f);
+    glm::vec2 gradientStart = glm::vec2(0.0f);
+    glm::vec2 gradientStep = glm::vec2(0.0f); // Direction over length squared, so a dot product gives 0-1
+    bool gradient = false;
+};
+
+// A headless canvas which rasterizes into an RGBA buffer in memory; no window or GPU required.
+// Useful for benchmarks, image comparison tests and thumbnails.
+// Every primitive is turned into pixel space polygon edges, and filled with exact area coverage anti-aliasing.
+class CanvasSoftware : public Canvas
+{
+public:
+    CanvasSoftware(const glm::uvec2& size, float worldScale = 1.0f, const glm::vec2& scaleLimits = glm::vec2(0.1f, 10.0f));
+
+    void Resize(const glm::uvec2& size);
+    glm::uvec2 GetSize() const;
+
+    // Rows top to bottom, one RGBA pixel per entry; packed the same as glm::packUnorm4x8
+    const std::vector<uint32_t>& GetPixels() const;
+
+    virtual void Begin(const glm::vec4& clearColor) override;
+    virtual void End() override;
+
+    virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) const override;
+
+protected:
+    virtual void OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) override;
+    virtual void OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) override;
+    virtual void OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRect(const NRectf& rc, const glm::vec4& color) override;
+
+    virtual void OnSetAA(bool set) override;
+    virtual void OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color) override;
+    virtual void OnBeginPath(const glm::vec2& from, const glm::vec4& color) override;
+    virtual void OnMoveTo(const glm::vec2& to) override;
+    virtual void OnLineTo(const glm::vec2& to) override;
+    virtual void OnClosePath() override;
+    virtual void OnEndPath() override;
+    virtual void OnEndStroke() override;
+    virtual void OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed) override;
+    virtual void OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color) override;
+
+    virtual void OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+    virtual void OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+
+    virtual void OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) override;
+
+    virtual void OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) override;
+
+    virtual void OnSetLineCap(LineCap cap) override;
+
+private:
+    SoftwarePaint SolidPaint(const glm::vec4& color) const;
+    SoftwarePaint GradientPaint(const NRectf& worldRange, const glm::vec4& startColor, const glm::vec4& endColor) const;
+
+    // Polygon building, all in pixel space
+    void AppendArc(std::vector<glm::vec2>& points, const glm::vec2& center, float radius, float startAngle, float endAngle) const;
+    void AppendRoundedRect(std::vector<glm::vec2>& points, const NRectf& worldRect, const glm::vec4& worldRadius) const;
+    void AddContour(std::span<const glm::vec2> points);
+    void AddStroke(std::span<const glm::vec2> points, float halfWidth, bool closed);
+
+    // Fill everything added since the last fill
+    void FillEdges(const SoftwarePaint& paint);
+    void AccumulateEdge(const glm::vec2& from, const glm::vec2& to, int width, int height);
+    void BlendSpan(uint32_t* pDest, const float* pCoverage, int count, const SoftwarePaint& paint, const glm::vec2& pixelStart);
+
+    void DrawGlyphs(const FontVertex* pVerts, int nverts, uint32_t color);
+    void SetupFont(const char* pszFace, float size, uint32_t align) const;
+
+private:
+    glm::uvec2 m_size = glm::uvec2(0);
+    std::vector<uint32_t> m_pixels;
+
+    std::vector<glm::vec2> m_edges; // Pairs of points
+    std::vector<float> m_coverage; // Signed area accumulation for the polygon bounds
+    std::vector<float> m_spanCoverage;
+    std::vector<glm::vec2> m_contour;
+
+    std::vector<glm::vec2> m_path;
+    glm::vec4 m_pathColor = glm::vec4(1.0f);
+    float m_pathWidth = 1.0f;
+    bool m_closePath = false;
+
+    int m_defaultFont = 0;
+    int m_fontIcon = 0;
+};
+
+} // namespace NodeGraph
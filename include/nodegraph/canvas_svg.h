@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include <nodegraph/canvas.h>
+
+namespace NodeGraph {
+
+// A canvas which writes SVG to a stream as it draws; nothing is kept for the whole document, so a
+// patch of any size can be exported in bounded memory.
+// Consecutive shapes of the same style are merged into a single <path>, and gradients and
+// font styles are written once into a <defs> block and referenced after that.
+class CanvasSVG : public Canvas
+{
+public:
+    CanvasSVG(std::ostream& out, const glm::uvec2& size, float worldScale = 1.0f, const glm::vec2& scaleLimits = glm::vec2(0.1f, 10.0f));
+
+    void Resize(const glm::uvec2& size);
+    glm::uvec2 GetSize() const;
+
+    // Begin writes the document header, End closes it; one document per Begin/End
+    virtual void Begin(const glm::vec4& clearColor) override;
+    virtual void End() override;
+
+    virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align = TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER) const override;
+
+    virtual bool HasGradientVarying() const override
+    {
+        return true;
+    }
+
+protected:
+    virtual void OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color) override;
+    virtual void OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color) override;
+    virtual void OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor) override;
+    virtual void OnFillRect(const NRectf& rc, const glm::vec4& color) override;
+
+    virtual void OnSetAA(bool set) override;
+    virtual void OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color) override;
+    virtual void OnBeginPath(const glm::vec2& from, const glm::vec4& color) override;
+    virtual void OnMoveTo(const glm::vec2& to) override;
+    virtual void OnLineTo(const glm::vec2& to) override;
+    virtual void OnClosePath() override;
+    virtual void OnEndPath() override;
+    virtual void OnEndStroke() override;
+    virtual void OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed) override;
+    virtual void OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color) override;
+
+    virtual void OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+    virtual void OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align) override;
+
+    virtual void OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color) override;
+
+    virtual void OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle) override;
+
+    virtual void OnSetLineCap(LineCap cap) override;
+
+private:
+    enum class BatchType
+    {
+        None,
+        Fill,
+        Stroke
+    };
+
+    // Shapes are appended to the open batch while the style matches; anything else flushes it first
+    std::string& BeginBatch(BatchType type, const glm::vec4& color, float width = 0.0f);
+    void FlushBatch();
+
+    // Path data, all in pixel space
+    void AppendRoundedRect(std::string& d, const NRectf& worldRect, const glm::vec4& worldRadius) const;
+    void AppendCircle(std::string& d, const glm::vec2& worldCenter, float worldRadius) const;
+
+    // A one off shape filled with a linear gradient
+    void WriteGradientShape(const std::string& d, const NRectf& worldBounds, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor);
+    uint32_t GradientDef(const glm::vec4& vector, const glm::vec4& startColor, const glm::vec4& endColor);
+    uint32_t FontDef(const char* pszFace, float pixelSize, uint32_t align);
+    void WriteText(const glm::vec2& pixelPos, const char* pszText, const char* pszEnd, uint32_t fontDef, const glm::vec4& color);
+    void SetupFont(const char* pszFace, float size, uint32_t align) const;
+
+private:
+    std::ostream& m_out;
+    glm::uvec2 m_size = glm::uvec2(0);
+
+    std::string m_batch; // Path data of the open batch
+    BatchType m_batchType = BatchType::None;
+    glm::vec4 m_batchColor = glm::vec4(0.0f);
+    float m_batchWidth = 0.0f;
+
+    std::string m_path; // BeginPath/BeginStroke ... End
+    std::string m_line; // Scratch for one element
+    glm::vec4 m_pathColor = glm::vec4(1.0f);
+    float m_pathWidth = 1.0f;
+    bool m_closePath = false;
+    LineCap m_lineCap = LineCap::ROUND;
+    bool m_antiAlias = true;
+
+    // Definitions already written, keyed on their content
+    std::unordered_map<std::string, uint32_t> m_defs;
+    uint32_t m_nextDefId = 1;
+
+    int m_defaultFont = 0;
+    int m_fontIcon = 0;
+};
+
+} // namespace NodeGraph
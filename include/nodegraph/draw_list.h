@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <zest/math/math_utils.h>
+
+namespace NodeGraph {
+
+class Canvas;
+enum class LineCap;
+struct CableDesc;
+struct PolylineRun;
+
+using Zest::NRectf;
+
+enum class DrawCmdType : uint8_t
+{
+    FilledCircle,
+    FilledGradientCircle,
+    FillRoundedRect,
+    FillRect,
+    FillGradientRoundedRect,
+    FillGradientRoundedRectVarying,
+    Stroke,
+    Arc,
+    SetAA,
+    BeginStroke,
+    BeginPath,
+    MoveTo,
+    LineTo,
+    SetLineCap,
+    ClosePath,
+    EndPath,
+    EndStroke,
+    Polyline,
+    Text,
+    TextBox,
+    Slab,
+    FillConvexPolygon,
+    Polylines,
+    Cables
+};
+
+const size_t DrawCmdTypeCount = size_t(DrawCmdType::Cables) + 1;
+
+// A single recorded primitive; the arguments live in the owning list's data stream
+struct DrawCmd
+{
+    DrawCmdType type;
+    uint32_t flags = 0; // Text alignment, line cap, AA state or closed path
+    uint32_t dataOffset = 0; // Index of the first float argument
+    uint32_t textOffset = 0; // Offsets into the string pool
+    uint32_t faceOffset = 0;
+};
+
+// A compact, backend agnostic buffer of canvas primitives, all in world space.
+// Widgets record into it via Canvas::BeginCapture, and the canvas replays it to the backend
+// on later frames for as long as nothing about the widget has changed.
+class DrawList
+{
+public:
+    static const uint32_t NoText = 0xFFFFFFFF;
+
+    void Clear();
+    bool Empty() const;
+    size_t Size() const;
+
+    // Send every recorded command to the canvas
+    void Replay(Canvas& canvas) const;
+
+    // Binary form, used for draw traces; the arrays are written as they are in memory, so a trace
+    // only reads back on a machine of the same endianness
+    void Write(std::ostream& out) const;
+    bool Read(std::istream& in);
+
+    // The canvas draw cache generation this list was recorded against
+    uint64_t GetGeneration() const;
+    void SetGeneration(uint64_t generation);
+
+    // A list recorded with some children culled is only valid while the view doesn't move
+    void SetViewDependent(const NRectf& visibleRect);
+    bool IsValidForView(const NRectf& visibleRect) const;
+
+    // Recording
+    void FilledCircle(const glm::vec2& center, float radius, const glm::vec4& color);
+    void FilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor);
+    void FillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color);
+    void FillRect(const NRectf& rc, const glm::vec4& color);
+    void FillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor);
+    void FillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor);
+    void Stroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color);
+    void Arc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle);
+    void SetAA(bool set);
+    void BeginStroke(const glm::vec2& from, float width, const glm::vec4& color);
+    void BeginPath(const glm::vec2& from, const glm::vec4& color);
+    void MoveTo(const glm::vec2& to);
+    void LineTo(const glm::vec2& to);
+    void SetLineCap(LineCap cap);
+    void ClosePath();
+    void EndPath();
+    void EndStroke();
+    void Polyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed);
+    void FillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color);
+
+    // A batch replays as a batch; cables keep their descriptions, and are culled and tessellated again on replay
+    void Polylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs);
+    void Cables(std::span<const CableDesc> cables);
+    void Text(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align);
+    void TextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align);
+    void Slab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor);
+
+private:
+    DrawCmd& Push(DrawCmdType type, uint32_t flags = 0);
+    void PushData(float val);
+    void PushData(const glm::vec2& val);
+    void PushData(const glm::vec4& val);
+    void PushData(const NRectf& val);
+    uint32_t PushText(const char* pszText);
+
+private:
+    std::vector<DrawCmd> m_commands;
+    std::vector<float> m_data;
+    std::vector<char> m_text;
+    uint64_t m_generation = 0;
+    bool m_viewDependent = false;
+    NRectf m_viewRect;
+};
+
+} // namespace NodeGraph
@@ -1,6 +1,9 @@
 #pragma once
 #include <cstdint>
+#include <functional>
 #include <nodegraph/fontstash.h>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace NodeGraph {
@@ -34,6 +37,59 @@ struct IFontTexture
     virtual void EndFrame() = 0;
 };
 
+// For backends without a GPU; the 'texture' only remembers its size, and glyphs are read back from fonsGetTextureData
+struct FontTextureNull : public IFontTexture
+{
+    virtual int UpdateTexture(int image, int x, int y, int w, int h, const unsigned char* data) override
+    {
+        return 1;
+    }
+
+    virtual int CreateTexture(int w, int h, const unsigned char* data) override
+    {
+        auto id = m_nextId++;
+        m_sizes[id] = std::make_pair(w, h);
+        return id;
+    }
+
+    virtual void DeleteTexture(int image) override
+    {
+        m_sizes.erase(image);
+    }
+
+    virtual void GetTextureSize(int image, int* w, int* h) override
+    {
+        auto itr = m_sizes.find(image);
+        *w = itr != m_sizes.end() ? itr->second.first : 0;
+        *h = itr != m_sizes.end() ? itr->second.second : 0;
+    }
+
+    virtual void* GetTexture(int image) override
+    {
+        return reinterpret_cast<void*>(intptr_t(image));
+    }
+
+    virtual void BeginFrame() override
+    {
+    }
+
+    virtual void EndFrame() override
+    {
+    }
+
+    std::unordered_map<int, std::pair<int, int>> m_sizes;
+    int m_nextId = 1;
+};
+
+// A glyph quad is emitted as a pair of these; top left then bottom right, in pixels
+struct FontVertex
+{
+    float x, y, u, v;
+};
+
+// Optional replacement for the ImGui text output, given the glyph quads and a packed RGBA color
+using FontRenderFn = std::function<void(const FontVertex* pVerts, int nverts, uint32_t color)>;
+
 struct FontContext
 {
     struct FONScontext* fs;
@@ -50,6 +106,8 @@ struct FontContext
     float devicePxRatio = 1.0f;
     void* userPtr = nullptr;
     float alpha = 1.0f;
+    FontRenderFn fnRenderText;
+    std::vector<FontVertex> vertices; // Scratch for a run of glyph quads, kept between calls
 };
 
 struct NVGglyphPosition
@@ -94,6 +152,7 @@ float fonts_draw_text(FontContext& ctx, float x, float y, uint32_t color, const
 void fonts_text_box(FontContext& ctx, float x, float y, float breakRowWidth, uint32_t color, const char* string, const char* end);
 float fonts_text_bounds(FontContext& ctx, float x, float y, const char* string, const char* end, float* bounds);
 void fonts_text_box_bounds(FontContext& ctx, float x, float y, float breakRowWidth, const char* string, const char* end, float* bounds);
+int fonts_break_lines(FontContext& ctx, const char* string, const char* end, float breakRowWidth, NVGtextRow* rows, int maxRows);
 
 void fonts_end_frame(FontContext& ctx);
 void fonts_begin_frame(FontContext& ctx);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace NodeGraph {
+
+// A bump allocator for data that only lives until the next frame, for use with the std::pmr containers.
+// Frees are ignored and everything is released at once by Reset. The blocks are kept between frames, and
+// after a frame that needed more than one they are merged into a single block big enough for all of it,
+// so once the frame size settles it makes no heap allocations.
+class FrameArena : public std::pmr::memory_resource
+{
+public:
+    explicit FrameArena(size_t blockSize = 64 * 1024);
+
+    void Reset();
+
+    // Bytes handed out since the last reset
+    size_t GetBytesUsed() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    void AddBlock(size_t size);
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> spData;
+        size_t size = 0;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_offset = 0; // Into the last block
+    size_t m_bytesUsed = 0;
+};
+
+} // namespace NodeGraph
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <zest/math/math_utils.h>
+
+namespace NodeGraph {
+
+class Widget;
+
+using Zest::NRectf;
+
+// A slot in a NodeStore, and the generation of the node that was in it when the handle was made.
+// Once the node is removed and the slot reused, the old handle no longer resolves.
+struct NodeHandle
+{
+    static constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0;
+
+    bool operator==(const NodeHandle& rhs) const = default;
+};
+
+// An optional data oriented store for very large graphs.
+// The rect, flags, z order and parent of each node live in parallel arrays indexed by slot, and a
+// flattened pre-order walk of the hierarchy is kept alongside; it is only rebuilt when nodes are
+// added, removed or reordered. Culling, moving, hit testing and serializing are then plain loops
+// over the arrays, with no shared_ptrs, virtual calls or std::function visits.
+// Rects are in world space. A node can point at the widget that draws it, but doesn't have to.
+class NodeStore
+{
+public:
+    NodeHandle Add(const NRectf& worldRect, NodeHandle parent = NodeHandle(), Widget* pWidget = nullptr);
+
+    // Removes the node and everything below it
+    void Remove(NodeHandle node);
+    void Clear();
+
+    bool IsValid(NodeHandle node) const;
+    size_t Size() const;
+
+    const NRectf& GetRect(NodeHandle node) const;
+    void SetRect(NodeHandle node, const NRectf& worldRect);
+    uint64_t GetFlags(NodeHandle node) const;
+    void SetFlags(NodeHandle node, uint64_t flags);
+    NodeHandle GetParent(NodeHandle node) const;
+    Widget* GetWidget(NodeHandle node) const;
+
+    // In front of its siblings
+    void Raise(NodeHandle node);
+
+    // Slots in draw order; parents before their children, siblings back to front
+    std::span<const uint32_t> GetPreOrder();
+    NodeHandle HandleAt(uint32_t index) const;
+
+    // The nodes overlapping the rect, in draw order. A node outside it is skipped along with its children.
+    void Cull(const NRectf& worldRect, std::vector<NodeHandle>& visible);
+
+    // Offset the nodes and everything below them; a node is only moved once, even if an ancestor is also in the list
+    void Move(std::span<const NodeHandle> nodes, const glm::vec2& worldDelta);
+
+    // The front most node under the point, or an invalid handle
+    NodeHandle HitTest(const glm::vec2& worldPos);
+
+    // The rects, flags and hierarchy, in draw order. Widget pointers are not written, and handles
+    // from before a Read are not valid after it.
+    void Write(std::ostream& out);
+    bool Read(std::istream& in);
+
+private:
+    void EnsurePreOrder();
+
+private:
+    std::vector<NRectf> m_rects;
+    std::vector<uint64_t> m_flags;
+    std::vector<int64_t> m_z;
+    std::vector<uint32_t> m_parents; // Slot of the parent, or InvalidIndex for a top level node
+    std::vector<uint32_t> m_generations;
+    std::vector<uint8_t> m_alive;
+    std::vector<Widget*> m_widgets;
+    std::vector<uint32_t> m_freeSlots;
+    int64_t m_frontZ = 0;
+
+    // Flattened hierarchy; rebuilt on structural change
+    std::vector<uint32_t> m_preOrder; // Slots, in draw order
+    std::vector<uint32_t> m_subtreeEnd; // Per pre-order position; one past the node's last descendant
+    std::vector<uint32_t> m_preOrderPos; // Per slot; its position in m_preOrder
+    bool m_structureDirty = true;
+};
+
+} // namespace NodeGraph
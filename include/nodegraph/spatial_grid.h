@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <zest/math/math_utils.h>
+
+namespace NodeGraph {
+
+class Widget;
+
+using Zest::NRectf;
+
+// A uniform grid over the world rects of the top level widgets, used for hit testing.
+// Each widget is bucketed into every cell it overlaps, and carries a z value so that a
+// pointer query can return its few candidates in front to back order without walking the
+// whole widget list.
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(float cellSize = 256.0f);
+
+    void Clear();
+
+    // Add or move a widget; the rect is in world space
+    void Update(Widget* pWidget, const NRectf& worldRect);
+    void Remove(Widget* pWidget);
+
+    // Z order; the raised widget is in front of everything else, the lowered one behind
+    void Raise(Widget* pWidget);
+    void Lower(Widget* pWidget);
+
+    // All widgets whose rect contains the point, front to back
+    void Query(const glm::vec2& worldPos, std::vector<Widget*>& results) const;
+
+    size_t Size() const;
+
+private:
+    struct Entry
+    {
+        Widget* pWidget = nullptr;
+        NRectf rect;
+        int64_t z = 0;
+        glm::ivec4 cells = glm::ivec4(0); // Min x/y, max x/y cell coordinates covered
+    };
+
+    glm::ivec2 CellCoord(const glm::vec2& pos) const;
+    static uint64_t CellKey(int x, int y);
+    void AddToCells(uint32_t entryIndex);
+    void RemoveFromCells(uint32_t entryIndex);
+
+private:
+    float m_cellSize;
+    std::vector<Entry> m_entries;
+    std::unordered_map<Widget*, uint32_t> m_lookup;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+    int64_t m_frontZ = 0;
+    int64_t m_backZ = 0;
+    mutable std::vector<const Entry*> m_hits; // Query scratch, kept so that hit tests don't allocate
+};
+
+} // namespace NodeGraph
@@ -87,5 +87,9 @@ DECLARE_THEME_SETTING_VALUE(c_socketShadowColor);
 DECLARE_THEME_SETTING_VALUE(c_waveSliderCenterColor);
 DECLARE_THEME_SETTING_VALUE(c_waveSliderBorderColor);
 
+// Level of detail; on screen pixel sizes below which detail is dropped
+DECLARE_THEME_SETTING_VALUE(s_lodNodeTitlePixels);
+DECLARE_THEME_SETTING_VALUE(s_lodCableCurvePixels);
+
 } // namespace Nodegraph
 
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <zest/settings/settings.h>
+
+namespace NodeGraph {
+
+// Every theme setting, read out of the settings manager in one go. Widgets draw from these plain
+// fields instead of doing a hashed lookup per value per draw; the canvas resolves it again when the
+// current theme changes or its draw cache is invalidated (which is what theme edits do).
+struct ThemeCache
+{
+    // Grid
+    glm::vec2 gridLineSize = glm::vec2(0.0f);
+    glm::vec4 gridLines = glm::vec4(0.0f);
+
+    // Node
+    float nodeBorderRadius = 0.0f;
+    float nodeShadowSize = 0.0f;
+    float nodeBorderSize = 0.0f;
+    glm::vec4 nodeShadowColor = glm::vec4(0.0f);
+    glm::vec4 nodeCenterColor = glm::vec4(0.0f);
+    glm::vec4 nodeBorderColor = glm::vec4(0.0f);
+
+    // - Title
+    float nodeTitleSize = 0.0f;
+    float nodeTitleFontPad = 0.0f;
+    float nodeTitleBorder = 0.0f;
+    float nodeTitleBorderRadius = 0.0f;
+    float nodeTitlePad = 0.0f;
+    float nodeTitleShadowSize = 0.0f;
+    float nodeTitleBorderSize = 0.0f;
+
+    glm::vec4 nodeTitleShadowColor = glm::vec4(0.0f);
+    glm::vec4 nodeTitleCenterColor = glm::vec4(0.0f);
+    glm::vec4 nodeTitleBorderColor = glm::vec4(0.0f);
+
+    // Slider
+    float sliderBorderSize = 0.0f;
+
+    float sliderThumbPad = 0.0f;
+    float sliderThumbShadowSize = 0.0f;
+    float sliderThumbRadius = 0.0f;
+    glm::vec4 sliderThumbShadowColor = glm::vec4(0.0f);
+    glm::vec4 sliderThumbColor = glm::vec4(0.0f);
+
+    float sliderBorderRadius = 0.0f;
+    float sliderShadowSize = 0.0f;
+    float sliderFontPad = 0.0f;
+    glm::vec4 sliderBorderColor = glm::vec4(0.0f);
+    glm::vec4 sliderCenterColor = glm::vec4(0.0f);
+    glm::vec4 sliderShadowColor = glm::vec4(0.0f);
+
+    float sliderTipBorderRadius = 0.0f;
+    float sliderTipShadowSize = 0.0f;
+    float sliderTipFontPad = 0.0f;
+    float sliderTipFontSize = 0.0f;
+    float sliderTipBorderSize = 0.0f;
+    glm::vec4 sliderTipBorderColor = glm::vec4(0.0f);
+    glm::vec4 sliderTipCenterColor = glm::vec4(0.0f);
+    glm::vec4 sliderTipShadowColor = glm::vec4(0.0f);
+    glm::vec4 sliderTipFontColor = glm::vec4(0.0f);
+
+    glm::vec4 labelColor = glm::vec4(0.0f);
+    glm::vec4 knobChannelColor = glm::vec4(0.0f);
+    glm::vec4 knobShadowColor = glm::vec4(0.0f);
+    glm::vec4 knobChannelHLColor = glm::vec4(0.0f);
+    glm::vec4 knobMarkColor = glm::vec4(0.0f);
+    glm::vec4 knobMarkHLColor = glm::vec4(0.0f);
+    glm::vec4 knobFillColor = glm::vec4(0.0f);
+    glm::vec4 knobFillHLColor = glm::vec4(0.0f);
+    glm::vec4 knobTextColor = glm::vec4(0.0f);
+
+    float knobChannelWidth = 0.0f;
+    float knobChannelGap = 0.0f;
+    float knobShadowSize = 0.0f;
+    float knobTextSize = 0.0f;
+    float knobTextInset = 0.0f;
+
+    bool debugShowLayout = false;
+
+    glm::vec4 socketColor = glm::vec4(0.0f);
+    glm::vec4 socketShadowColor = glm::vec4(0.0f);
+
+    // Wave slider
+    glm::vec4 waveSliderCenterColor = glm::vec4(0.0f);
+    glm::vec4 waveSliderBorderColor = glm::vec4(0.0f);
+
+    // Level of detail; on screen pixel sizes below which detail is dropped
+    float lodNodeTitlePixels = 0.0f;
+    float lodCableCurvePixels = 0.0f;
+
+    void Resolve(const Zest::StringId& theme);
+};
+
+} // namespace NodeGraph
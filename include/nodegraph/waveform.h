@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace NodeGraph {
+
+// Summary of a run of samples
+struct WaveformBin
+{
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    float rms = 0.0f;
+};
+
+// A sample buffer with a min/max/RMS pyramid over it. Level 0 summarizes BinSamples samples per bin and
+// each level above it halves the resolution, so a view is drawn from the level nearest its samples per
+// column and costs the same per frame however long the buffer is. Appending only rebuilds the bins at
+// the end of each level, so live audio can be streamed in a block at a time.
+class Waveform
+{
+public:
+    static const uint32_t BinSamples = 16;
+
+    void Clear();
+    void Set(std::span<const float> samples);
+    void Append(std::span<const float> samples);
+
+    size_t GetSampleCount() const;
+    bool Empty() const;
+
+    // One bin per column over the samples [begin, end); with less than a sample per column each bin is a single sample
+    void Summarize(size_t begin, size_t end, uint32_t columns, std::vector<WaveformBin>& bins) const;
+
+private:
+    struct Bin
+    {
+        float minimum;
+        float maximum;
+        float squares; // Sum of squares, so bins can be merged before taking the root
+    };
+
+    void UpdateLevels(size_t firstSample);
+
+private:
+    std::vector<float> m_samples;
+    std::vector<std::vector<Bin>> m_levels; // Level n bins cover BinSamples << n samples
+};
+
+} // namespace NodeGraph
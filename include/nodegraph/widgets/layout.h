@@ -1,11 +1,13 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <nodegraph/widgets/widget.h>
 
 namespace NodeGraph {
 
 class Widget;
+class SpatialGrid;
 
 enum class LayoutType
 {
@@ -27,8 +29,8 @@ public:
     virtual void Update();
     virtual void AddChild(std::shared_ptr<Widget> spWidget);
 
-    virtual void MoveChildToFront(std::shared_ptr<Widget> pWidget);
-    virtual void MoveChildToBack(std::shared_ptr<Widget> pWidget);
+    virtual void MoveChildToFront(Widget* pWidget);
+    virtual void MoveChildToBack(Widget* pWidget);
 
     virtual const WidgetList& GetFrontToBack() const;
     virtual const WidgetList& GetBackToFront() const;
@@ -40,10 +42,26 @@ public:
     virtual void SetRect(const NRectf& sz) override;
     virtual NRectf GetRectWithPad() const override;
     virtual void SetRectWithPad(const NRectf& rc) override;
+    virtual void InvalidateWorldRect() override;
+    virtual void InvalidateLayout() override;
+    virtual Layout* AsLayout() override;
+    virtual void MarkDirty() override;
+
+    // While held, dirty marks, layout invalidations and rect changes coming up from the children are
+    // queued, and applied on the releasing thread. The canvas holds its root while top level widgets
+    // record on several threads, as they would otherwise all write to it (and its spatial grid) at once.
+    void SetHoldNotifications(bool hold);
 
     virtual void Draw(Canvas& canvas) override;
 
     virtual Layout* GetLayout() override;
+    virtual Layout* FindLayout() override;
+    virtual std::span<const std::shared_ptr<Widget>> ChildrenFrontToBack() const override;
+    virtual std::span<const std::shared_ptr<Widget>> ChildrenBackToFront() const override;
+
+    // An optional index of the children's world rects, kept up to date as they move
+    virtual void SetSpatialGrid(SpatialGrid* pGrid);
+    virtual void ChildRectChanged(Widget* pChild) override;
 
     virtual void SetContentsMargins(const glm::vec4& contentsMargins);
     virtual const glm::vec4& GetContentsMargins() const;
@@ -58,7 +76,7 @@ public:
 
     //virtual void Resize(const glm::vec2& size);
 
-    tWidgets GetNonFixedWidgets() const;
+    const std::vector<Widget*>& GetNonFixedWidgets() const;
 
 protected:
     enum class Axis
@@ -68,6 +86,7 @@ protected:
     };
     int GetAxisIndex(Axis axis) const;
     float SpaceForWidgets(size_t count) const;
+    void Arrange(const NRectf& rc);
 
 private:
     LayoutType m_layoutType = LayoutType::Horizontal;
@@ -76,6 +95,22 @@ private:
     NRectf m_innerRect;
     float m_spacing = 6.0f;
     glm::vec4 m_contentsMargins = glm::vec4(2.0f);
+    SpatialGrid* m_pSpatialGrid = nullptr;
+    mutable std::vector<Widget*> m_layoutWidgets;
+
+    // Layout cache; the rect last asked for (the layout's own rect can grow to fit), and the children's size hint
+    NRectf m_arrangedRect;
+    mutable SizeHint m_childrenHint;
+    mutable bool m_childrenHintValid = false;
+    bool m_layoutValid = false;
+    bool m_arranging = false; // Child rect changes are our own while this is set
+    bool m_holdNotifications = false;
+
+    // Notices that came in while held; from any thread, so behind the mutex
+    std::mutex m_heldMutex;
+    std::vector<Widget*> m_heldRectChanges;
+    bool m_heldInvalidate = false;
+    bool m_heldDirty = false;
 };
 
 }
\ No newline at end of file
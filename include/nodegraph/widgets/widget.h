@@ -3,6 +3,7 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <functional>
+#include <span>
 
 #include <zest/math/math_utils.h>
 #include <zest/time/timer.h>
@@ -14,6 +15,7 @@ namespace NodeGraph {
 class Canvas;
 struct CanvasInputState;
 class TipTimer;
+class DrawList;
 
 enum MouseButtons
 {
@@ -69,11 +71,43 @@ enum class TipState
 };
 
 class Widget;
-class TipTimer
+
+// Owned by a canvas; the clock its tips animate against, and an intrusive list of the tips that
+// are not Off. The clock is sampled once per Tick, so every tip in a frame sees the same time, and
+// walking or changing the active tips never allocates.
+class TipScheduler
 {
 public:
-    static std::unordered_map<Widget*, TipTimer*> ActiveTips;
+    TipScheduler();
+    ~TipScheduler();
+
+    // Sample the clock and advance the active tips
+    void Tick();
+    double Now() const;
 
+    // Walk the active tips with GetNextActive; a tip may leave the list when it is changed,
+    // so take the next one first
+    TipTimer* GetFirstActive() const;
+    size_t GetActiveCount() const;
+
+    // Is any tip waiting, fading in or fading out
+    bool IsAnimating() const;
+
+private:
+    friend class TipTimer;
+    void Link(TipTimer* pTip);
+    void Unlink(TipTimer* pTip);
+
+private:
+    Zest::timer m_clock;
+    double m_now = 0.0;
+    TipTimer* m_pFirstActive = nullptr;
+    size_t m_activeCount = 0;
+};
+
+class TipTimer
+{
+public:
     TipTimer(Widget* pOwner, float wait, float secondsIn, float secondsOut)
         : m_in(secondsIn)
         , m_out(secondsOut)
@@ -86,11 +120,13 @@ public:
 
     ~TipTimer()
     {
-        if (ActiveTips.find(m_pOwner) != ActiveTips.end())
+        if (m_pScheduler)
         {
-            ActiveTips.erase(m_pOwner);
+            m_pScheduler->Unlink(this);
         }
     }
+
+    // Called by the scheduler after it samples the clock
     TipState Update()
     {
         // Wait or decay over time
@@ -98,25 +134,26 @@ public:
         {
         case TipState::Wait:
         {
-            if (timer_get_elapsed_seconds(m_time) > m_wait)
+            if (Elapsed() > m_wait)
             {
-                SetState(TipState::Ramp);
+                SetState(TipState::Ramp, *m_pScheduler);
             }
         }
         break;
         case TipState::Ramp:
         {
-            if (timer_get_elapsed_seconds(m_time) > m_in)
+            if (Elapsed() > m_in)
             {
-                SetState(TipState::On);
+                SetState(TipState::On, *m_pScheduler);
             }
         }
         break;
         case TipState::Decay:
         {
-            if (timer_get_elapsed_seconds(m_time) > m_in)
+            // Off when the alpha reaches zero; a stopped ramp decays from part way
+            if (Elapsed() > m_decayTime)
             {
-                SetState(TipState::Off);
+                SetState(TipState::Off, *m_pScheduler);
             }
         }
         break;
@@ -126,7 +163,7 @@ public:
 
     float Alpha() const
     {
-        auto elapsed = float(timer_get_elapsed_seconds(m_time));
+        auto elapsed = float(Elapsed());
         if (m_state == TipState::Decay)
         {
             if (elapsed > m_decayTime)
@@ -146,14 +183,14 @@ public:
         return 0.0f;
     }
 
-    void Stop()
+    void Stop(TipScheduler& scheduler)
     {
         // If waiting, reverse to a decay for the remaining alpha
         if (m_state == TipState::Ramp)
         {
             auto a = Alpha();
             m_state = TipState::Decay;
-            timer_restart(m_time);
+            m_startTime = scheduler.Now();
             m_decayTime = m_out - (m_out * a);
         }
         else
@@ -161,49 +198,56 @@ public:
             // If on, switch to decay
             if (m_state == TipState::On || m_state == TipState::Decay)
             {
-                SetState(TipState::Decay);
+                SetState(TipState::Decay, scheduler);
             }
             else
             {
                 // Othwerise directly off
-                SetState(TipState::Off);
+                SetState(TipState::Off, scheduler);
             }
         }
     }
 
-    void Start()
+    void Start(TipScheduler& scheduler)
     {
         if (m_state != TipState::On && m_state != TipState::Ramp)
         {
-            SetState(TipState::Wait);
+            SetState(TipState::Wait, scheduler);
         }
     }
 
-    void SetState(TipState s)
+    // Redraws the owner, so that it is recorded again with the new state; it may not be in the
+    // active list to be redrawn once it is Off
+    void SetState(TipState s, TipScheduler& scheduler);
+
+    // As of the last Tick; doesn't read the clock
+    TipState GetState() const
     {
-        if (s == m_state)
-        {
-            return;
-        }
-        m_state = s;
-        m_decayTime = m_out;
-        timer_restart(m_time);
-        Update();
+        return m_state;
+    }
 
-        if (s != TipState::Off)
-        {
-            ActiveTips[m_pOwner] = this;
-        }
-        else
-        {
-            ActiveTips.erase(m_pOwner);
-        }
+    // Changing with time; a tip that is fully on stays as it is
+    bool IsAnimating() const
+    {
+        return m_state != TipState::On && m_state != TipState::Off;
     }
 
-    TipState GetState()
+    Widget* GetOwner() const
     {
-        Update();
-        return m_state;
+        return m_pOwner;
+    }
+
+    TipTimer* GetNextActive() const
+    {
+        return m_pNextActive;
+    }
+
+private:
+    friend class TipScheduler;
+
+    double Elapsed() const
+    {
+        return m_pScheduler ? m_pScheduler->Now() - m_startTime : 0.0;
     }
 
 private:
@@ -211,10 +255,14 @@ private:
     float m_in = 0.25f;
     float m_out = 0.25f;
     float m_decayTime = 0.0f;
-    bool on = false;
-    Zest::timer m_time;
+    double m_startTime = 0.0;
     TipState m_state = TipState::Off;
     Widget* m_pOwner;
+
+    // Active list links; set while the tip is not Off
+    TipScheduler* m_pScheduler = nullptr;
+    TipTimer* m_pPrevActive = nullptr;
+    TipTimer* m_pNextActive = nullptr;
 };
 
 class Layout;
@@ -248,11 +296,29 @@ public:
     virtual Zest::NRectf ToLocalRect(const Zest::NRectf& rc) const;
     virtual Zest::NRectf GetWorldRect() const;
 
+    // The world rect is cached; this drops it for the widget and everything below it
+    virtual void InvalidateWorldRect();
+
+    // Called by a child when its rect has moved or resized
+    virtual void ChildRectChanged(Widget* pChild);
+
+    // Layouts cache their arrangement; anything that changes a widget's size hint, constraints,
+    // padding or flags invalidates the layouts above it, so that they re-arrange on their next SetRect
+    virtual void InvalidateLayout();
+    virtual Layout* AsLayout();
+
     virtual const std::string& GetLabel() const;
     virtual void SetLabel(const char* pszLabel);
 
+    // GetLayout creates an empty vertical layout on first use, for adding children to.
+    // FindLayout doesn't; leaf widgets never have one, and return nullptr.
     virtual void SetLayout(std::shared_ptr<Layout> spLayout);
     virtual Layout* GetLayout();
+    virtual Layout* FindLayout();
+
+    // The children of the layout, or an empty span for a leaf
+    virtual std::span<const std::shared_ptr<Widget>> ChildrenFrontToBack() const;
+    virtual std::span<const std::shared_ptr<Widget>> ChildrenBackToFront() const;
 
     virtual uint64_t GetFlags() const;
     virtual void SetFlags(uint64_t flags);
@@ -281,11 +347,20 @@ public:
 
     void Visit(const std::function<void(Widget*)>& fnVisit);
 
+    // Draw caching; a dirty widget dirties its parents, and top level widgets re-record their
+    // commands on the next draw. Callbacks that change values outside of the widget should mark it.
+    virtual void MarkDirty();
+    virtual bool IsDirty() const;
+    virtual void ClearDirty();
+    DrawList& GetDrawCache();
+
     fteng::signal<void()> ValueUpdatedSignal;
     fteng::signal<void(Canvas& canvas, const Zest::NRectf& hintRect)> PostDrawSignal;
 
 protected:
     Zest::NRectf m_rect;
+    mutable Zest::NRectf m_worldRect;
+    mutable bool m_worldRectValid = false;
     Widget* m_pParent = nullptr;
     std::string m_label;
     glm::uvec2 m_constraints = glm::uvec2(LayoutConstraint::Expanding, LayoutConstraint::Expanding);
@@ -294,6 +369,8 @@ protected:
     uint64_t m_flags = 0;
     glm::vec2 m_sizeHint = glm::vec2(0.0f);
     TipTimer m_tipTimer;
+    bool m_dirty = true;
+    std::shared_ptr<DrawList> m_spDrawCache;
 };
 
 }
\ No newline at end of file
@@ -1,4 +1,8 @@
 #pragma once
+
+#include <span>
+
+#include <nodegraph/waveform.h>
 #include <nodegraph/widgets/widget_slider.h>
 
 namespace NodeGraph {
@@ -19,10 +23,15 @@ public:
     virtual void PostDraw(Canvas& canvas, const NRectf& rc);
     virtual void DrawGeneratedWave(Canvas& canvas, const NRectf& rc);
 
-    void SetWave(const std::vector<float>& vals);
+    // Replace the displayed wave, or stream more onto the end of it
+    void SetWave(std::span<const float> vals);
+    void AppendWave(std::span<const float> vals);
+    const Waveform& GetWaveform() const;
 
 private:
-    std::vector<float> m_wave;
+    Waveform m_waveform;
+    std::vector<WaveformBin> m_waveBins;
+    std::vector<glm::vec2> m_wavePoints; // Scratch, reused for every line drawn
 };
 
 }
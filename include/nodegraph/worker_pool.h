@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NodeGraph {
+
+// A fixed set of threads for splitting a loop over items.
+// The calling thread takes part as worker 0, and Run returns once every item is done. Items are
+// handed out one at a time from a shared counter, so uneven items still balance across the workers.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(uint32_t workerCount);
+    ~WorkerPool();
+
+    // Including the calling thread
+    uint32_t GetWorkerCount() const;
+
+    // Calls fn(item, worker) for every item in [0, count)
+    void Run(size_t count, const std::function<void(size_t, uint32_t)>& fn);
+
+private:
+    void ThreadMain(uint32_t worker);
+    void Work(uint32_t worker);
+
+private:
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(size_t, uint32_t)>* m_pFn = nullptr;
+    size_t m_count = 0;
+    std::atomic<size_t> m_next = 0;
+    uint32_t m_running = 0; // Threads still working on the current run
+    uint64_t m_generation = 0; // Bumped for each run, so that waiting threads know there is work
+    bool m_quit = false;
+};
+
+} // namespace NodeGraph
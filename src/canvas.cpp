@@ -4,7 +4,11 @@
 #include <zest/time/timer.h>
 
 #include <nodegraph/canvas.h>
+#include <nodegraph/canvas_null.h>
+#include <nodegraph/draw_list.h>
 #include <nodegraph/fonts.h>
+#include <nodegraph/spatial_grid.h>
+#include <nodegraph/worker_pool.h>
 #include <nodegraph/widgets/layout.h>
 
 #include <algorithm>
@@ -22,6 +26,72 @@
 
 namespace NodeGraph {
 
+// Records top level widgets on one worker thread, on behalf of a canvas.
+// It has its own capture, frame arena and scratch space, and a copy of the canvas view, input state
+// and theme taken before each parallel pass. Text is measured by the canvas, one worker at a time.
+class RecordWorker : public CanvasNull
+{
+public:
+    RecordWorker(Canvas& owner)
+        : CanvasNull(owner.GetPixelRegionSize(), owner.GetWorldScale())
+        , m_owner(owner)
+    {
+    }
+
+    void Sync()
+    {
+        m_frameArena.Reset();
+        m_pixelSize = m_owner.m_pixelSize;
+        m_worldOrigin = m_owner.m_worldOrigin;
+        m_worldScale = m_owner.m_worldScale;
+        m_worldScaleLimits = m_owner.m_worldScaleLimits;
+        m_inputState = m_owner.m_inputState;
+        m_theme = m_owner.m_theme;
+        m_themeId = m_owner.m_themeId;
+        m_themeValid = m_owner.m_themeValid;
+        m_drawCacheGeneration = m_owner.m_drawCacheGeneration;
+    }
+
+    virtual NRectf TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align) const override
+    {
+        std::lock_guard<std::mutex> lock(m_owner.m_textMutex);
+        return m_owner.TextBounds(pos, size, pszText, pszFace, align);
+    }
+
+private:
+    Canvas& m_owner;
+};
+
+namespace {
+const float BezierPixelTolerance = 0.25f; // Max distance of the tessellation from the true curve, in pixels
+const int MaxBezierSegments = 256;
+
+// Tips, shadows and socket stubs stray a little outside of their widget rect; on screen, so it holds at any zoom
+const float CullMarginPixels = 64.0f;
+
+// Fewer widgets than this to record are not worth waking the workers for
+const size_t MinParallelRecordWidgets = 8;
+
+// Grid levels are a decade apart; the minor level fades in between these on screen spacings
+const float GridLevelScale = 10.0f;
+const float GridFadeStartPixels = 8.0f;
+const float GridFadeEndPixels = 32.0f;
+
+// How far the control points pull the curve away from the straight line between its ends
+float CurveDeviation(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4)
+{
+    auto chord = p4 - p1;
+    auto chordLength = glm::length(chord);
+    if (chordLength <= 0.0f)
+    {
+        return std::max(glm::length(p2 - p1), glm::length(p3 - p4));
+    }
+
+    auto normal = glm::vec2(-chord.y, chord.x) / chordLength;
+    return std::max(std::fabs(glm::dot(p2 - p1, normal)), std::fabs(glm::dot(p3 - p1, normal)));
+}
+}
+
 Canvas::Canvas(IFontTexture* pFontTexture, float worldScale, const glm::vec2& scaleLimits)
     : m_worldScale(worldScale)
     , m_worldScaleLimits(scaleLimits)
@@ -29,6 +99,9 @@ Canvas::Canvas(IFontTexture* pFontTexture, float worldScale, const glm::vec2& sc
     m_spRootLayout = std::make_shared<Layout>(LayoutType::Vertical);
     m_spRootLayout->SetLabel("Canvas Root Layout");
 
+    m_spSpatialGrid = std::make_shared<SpatialGrid>();
+    m_spRootLayout->SetSpatialGrid(m_spSpatialGrid.get());
+
     spFontContext = std::make_shared<FontContext>();
     fonts_init(*spFontContext, pFontTexture);
 }
@@ -53,7 +126,11 @@ float Canvas::GetWorldScale() const
 // This is the visible pixel rect, origin 0
 void Canvas::SetPixelRegionSize(const glm::vec2& sz)
 {
-    m_pixelSize = sz;
+    if (m_pixelSize != sz)
+    {
+        m_pixelSize = sz;
+        RequestRedraw();
+    }
 }
 
 glm::vec2 Canvas::GetPixelRegionSize() const
@@ -61,12 +138,46 @@ glm::vec2 Canvas::GetPixelRegionSize() const
     return m_pixelSize;
 }
 
+// The world space region covered by the pixel rect
+NRectf Canvas::GetVisibleWorldRect() const
+{
+    return NRectf(m_worldOrigin, PixelToWorld(m_pixelSize));
+}
+
+bool Canvas::IsVisible(const NRectf& worldRect)
+{
+    auto cullMargin = PixelSizeToWorldSize(CullMarginPixels);
+
+    auto visibleRect = GetVisibleWorldRect();
+    if (worldRect.Right() < (visibleRect.Left() - cullMargin) || worldRect.Left() > (visibleRect.Right() + cullMargin) || worldRect.Bottom() < (visibleRect.Top() - cullMargin) || worldRect.Top() > (visibleRect.Bottom() + cullMargin))
+    {
+        // A partially culled recording is only good for this view
+        if (m_pCapture)
+        {
+            m_captureCulled = true;
+        }
+        return false;
+    }
+    return true;
+}
+
 glm::vec2 Canvas::WorldToPixels(const glm::vec2& pos) const
 {
     auto worldTopLeft = pos - m_worldOrigin;
     return worldTopLeft * m_worldScale;
 }
 
+// Folded into one multiply-add per component, so the loop vectorizes
+void Canvas::WorldPointsToPixels(std::span<const glm::vec2> points, glm::vec2* pPixels, const glm::vec2& pixelOffset) const
+{
+    auto scale = m_worldScale;
+    auto offset = pixelOffset - m_worldOrigin * m_worldScale;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        pPixels[i] = points[i] * scale + offset;
+    }
+}
+
 NRectf Canvas::WorldToPixels(const NRectf& rc) const
 {
     auto worldTopLeft = (rc.topLeftPx - m_worldOrigin) * m_worldScale;
@@ -105,17 +216,159 @@ CanvasInputState& Canvas::GetInputState()
     return m_inputState;
 }
 
+glm::vec2 Canvas::GetWorldOrigin() const
+{
+    return m_worldOrigin;
+}
+
+void Canvas::SetWorldView(const glm::vec2& worldOrigin, float worldScale)
+{
+    m_worldOrigin = worldOrigin;
+    m_worldScale = worldScale;
+    RequestRedraw();
+}
+
 void Canvas::SetWorldAtCenter(const glm::vec2& world)
 {
     auto centerOffset = PixelToWorld(m_pixelSize / 2.0f);
     m_worldOrigin = world - centerOffset;
+    RequestRedraw();
 }
 
-// Handle the mouse wheel zoom and the right button panning, for manipulating the canvas
+void Canvas::PushInput(const CanvasInputEvent& event)
+{
+    // Nothing happened between the two moves, so only where the mouse ended up matters;
+    // drags work from the press position, and node moves from the total delta
+    if (!m_inputQueue.empty())
+    {
+        auto& last = m_inputQueue.back();
+        if (event.type == CanvasInputType::Move && last.type == CanvasInputType::Move)
+        {
+            last = event;
+            return;
+        }
+
+        if (event.type == CanvasInputType::Wheel && last.type == CanvasInputType::Wheel && event.mousePos == last.mousePos)
+        {
+            auto wheel = last.wheel + event.wheel;
+            last = event;
+            last.wheel = wheel;
+            return;
+        }
+    }
+    m_inputQueue.push_back(event);
+}
+
+// Handle the queued events in order, then leave the state with nothing pressed or moved this frame
 void Canvas::HandleMouse()
 {
+    m_tips.Tick();
+
+    auto& state = m_inputState;
+    for (auto& event : m_inputQueue)
+    {
+        // Buttons the state has no slot for, such as extra mouse buttons, are ignored
+        auto isButton = event.type == CanvasInputType::ButtonDown || event.type == CanvasInputType::ButtonUp;
+        if (isButton && event.button >= MOUSE_MAX)
+        {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < MOUSE_MAX; i++)
+        {
+            state.buttonClicked[i] = false;
+            state.buttonReleased[i] = false;
+        }
+        state.mouseDelta = event.mousePos - state.mousePos;
+        state.mousePos = event.mousePos;
+        state.wheelDelta = 0.0f;
+        state.time = event.time;
+
+        auto button = event.button;
+        switch (event.type)
+        {
+        case CanvasInputType::ButtonDown:
+            state.buttonClicked[button] = true;
+            state.buttonDown[button] = true;
+            m_buttonDownPos[button] = event.mousePos;
+            if (button == MOUSE_LEFT && (event.modifiers & InputModifiers::Ctrl))
+            {
+                state.slowDrag = true;
+            }
+            break;
+        case CanvasInputType::ButtonUp:
+            state.buttonReleased[button] = true;
+            state.buttonDown[button] = false;
+            if (button == MOUSE_LEFT)
+            {
+                state.slowDrag = false;
+            }
+            break;
+        case CanvasInputType::Wheel:
+            state.wheelDelta = event.wheel;
+            break;
+        default:
+            break;
+        }
+
+        if (state.buttonDown[MOUSE_LEFT])
+        {
+            state.dragDelta = state.mousePos - m_buttonDownPos[MOUSE_LEFT];
+        }
+        else if (state.buttonDown[MOUSE_RIGHT])
+        {
+            state.dragDelta = state.mousePos - m_buttonDownPos[MOUSE_RIGHT];
+        }
+        else
+        {
+            state.dragDelta = glm::vec2(0.0f);
+        }
+
+        state.worldMousePos = PixelToWorld(state.mousePos);
+        state.worldDragDelta = state.dragDelta / m_worldScale;
+        state.worldMoveDelta = state.mouseDelta / m_worldScale;
+        if (event.type == CanvasInputType::ButtonDown)
+        {
+            state.lastWorldMouseClick[button] = state.worldMousePos;
+        }
+
+        HandleInputState();
+    }
+
+    // A host that fills in the state itself, rather than queueing events, is handled as one event
+    if (m_inputQueue.empty())
+    {
+        HandleInputState();
+        return;
+    }
+    m_inputQueue.clear();
+
     for (uint32_t i = 0; i < MOUSE_MAX; i++)
     {
+        state.buttonClicked[i] = false;
+        state.buttonReleased[i] = false;
+    }
+    state.mouseDelta = glm::vec2(0.0f);
+    state.worldMoveDelta = glm::vec2(0.0f);
+    state.wheelDelta = 0.0f;
+}
+
+// Handle the mouse wheel zoom and the right button panning, for manipulating the canvas
+void Canvas::HandleInputState()
+{
+    // Any input at all may change what is drawn; hover, capture, panning and zooming
+    if (m_inputState.mouseDelta.x != 0.0f || m_inputState.mouseDelta.y != 0.0f || m_inputState.wheelDelta != 0.0f)
+    {
+        RequestRedraw();
+    }
+
+    for (uint32_t i = 0; i < MOUSE_MAX; i++)
+    {
+        if (m_inputState.buttonClicked[i] || m_inputState.buttonReleased[i])
+        {
+            RequestRedraw();
+        }
+
         if (m_inputState.buttonClicked[i])
         {
             HandleMouseDown(m_inputState);
@@ -168,30 +421,73 @@ void Canvas::HandleMouse()
     }
 }
 
+bool Canvas::IsDetailVisible(float worldSize, float minPixelSize) const
+{
+    return WorldSizeToPixelSize(worldSize) >= minPixelSize;
+}
+
 void Canvas::DrawGrid(float worldStep)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    if (m_gridOrigin == m_worldOrigin && m_gridPixelSize == m_pixelSize && m_gridScale == m_worldScale && m_gridStep == worldStep && m_gridGeneration == m_drawCacheGeneration)
+    {
+        SubmitPolylines(m_gridPoints, m_gridRuns);
+        return;
+    }
+
+    m_gridOrigin = m_worldOrigin;
+    m_gridPixelSize = m_pixelSize;
+    m_gridScale = m_worldScale;
+    m_gridStep = worldStep;
+    m_gridGeneration = m_drawCacheGeneration;
+    m_gridPoints.clear();
+    m_gridRuns.clear();
+
+    auto& theme = GetTheme();
+
+    auto size = (theme.gridLineSize / m_worldScale);
+    auto lineColor = theme.gridLines;
+
+    // Step up by decades until the minor lines are far enough apart to be worth drawing,
+    // and fade them in as they open up; the major lines are always at full strength.
+    auto minorStep = worldStep;
+    while (WorldSizeToPixelSize(minorStep) < GridFadeStartPixels)
+    {
+        minorStep *= GridLevelScale;
+    }
+    auto majorStep = minorStep * GridLevelScale;
+    auto minorFade = std::clamp((WorldSizeToPixelSize(minorStep) - GridFadeStartPixels) / (GridFadeEndPixels - GridFadeStartPixels), 0.0f, 1.0f);
+    auto minorColor = glm::vec4(lineColor.x, lineColor.y, lineColor.z, lineColor.w * minorFade);
+
+    auto worldBottomRight = PixelToWorld(m_pixelSize);
 
-    auto startPos = m_worldOrigin;
-    startPos.x = std::floor(m_worldOrigin.x / worldStep) * worldStep;
-    startPos.y = std::floor(m_worldOrigin.y / worldStep) * worldStep;
+    auto addLine = [&](const glm::vec2& from, const glm::vec2& to, float pos, float width) {
+        auto isMajor = std::fabs(std::remainder(pos, majorStep)) < (minorStep * 0.5f);
+        if (!isMajor && minorFade <= 0.0f)
+        {
+            return;
+        }
 
-    auto size = (settings.GetVec2f(theme, s_gridLineSize) / m_worldScale);
-    auto lineColor = settings.GetVec4f(theme, c_gridLines);
+        PolylineRun run;
+        run.offset = uint32_t(m_gridPoints.size());
+        run.count = 2;
+        run.color = isMajor ? lineColor : minorColor;
+        run.width = width;
+        m_gridRuns.push_back(run);
+        m_gridPoints.push_back(from);
+        m_gridPoints.push_back(to);
+    };
 
-    while (startPos.x < PixelToWorld(m_pixelSize).x)
+    for (auto x = std::floor(m_worldOrigin.x / minorStep) * minorStep; x < worldBottomRight.x; x += minorStep)
     {
-        Stroke(glm::vec2(startPos.x, startPos.y), glm::vec2(startPos.x, PixelToWorld(m_pixelSize).y), size.y, lineColor);
-        startPos.x += worldStep;
+        addLine(glm::vec2(x, m_worldOrigin.y), glm::vec2(x, worldBottomRight.y), x, size.y);
     }
 
-    startPos.x = std::floor(m_worldOrigin.x / worldStep) * worldStep;
-    while (startPos.y < PixelToWorld(m_pixelSize).y)
+    for (auto y = std::floor(m_worldOrigin.y / minorStep) * minorStep; y < worldBottomRight.y; y += minorStep)
     {
-        Stroke(glm::vec2(startPos.x, startPos.y), glm::vec2(PixelToWorld(m_pixelSize).x, startPos.y), size.x, lineColor);
-        startPos.y += worldStep;
+        addLine(glm::vec2(m_worldOrigin.x, y), glm::vec2(worldBottomRight.x, y), y, size.x);
     }
+
+    SubmitPolylines(m_gridPoints, m_gridRuns);
 }
 
 void Canvas::DrawLine(const glm::vec2& from, const glm::vec2& to, const glm::vec4& color, float width)
@@ -201,43 +497,55 @@ void Canvas::DrawLine(const glm::vec2& from, const glm::vec2& to, const glm::vec
     EndStroke();
 }
 
-void Canvas::CubicBezier(std::vector<glm::vec2>& path, float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, float tess_tol, int level)
+// Appends the points after p1, evaluated by forward differencing. The segment count comes from Wang's formula,
+// so the curve stays within the tolerance in pixels whatever the zoom.
+void Canvas::CubicBezier(std::vector<glm::vec2>& path, const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4, float pixelTolerance)
 {
-    float dx = x4 - x1;
-    float dy = y4 - y1;
-    float d2 = (x2 - x4) * dy - (y2 - y4) * dx;
-    float d3 = (x3 - x4) * dy - (y3 - y4) * dx;
-    d2 = (d2 >= 0) ? d2 : -d2;
-    d3 = (d3 >= 0) ? d3 : -d3;
-    if ((d2 + d3) * (d2 + d3) < tess_tol * (dx * dx + dy * dy))
-    {
-        path.push_back(glm::vec2(x4, y4));
-    }
-    else if (level < 10)
+    auto secondDiff = std::max(glm::length(p1 - 2.0f * p2 + p3), glm::length(p2 - 2.0f * p3 + p4));
+    auto pixelDiff = WorldSizeToPixelSize(secondDiff);
+    auto segments = int(std::ceil(std::sqrt(0.75f * pixelDiff / pixelTolerance)));
+    segments = std::clamp(segments, 1, MaxBezierSegments);
+
+    // Power basis coefficients; B(t) = a*t^3 + b*t^2 + c*t + p1
+    auto a = -p1 + 3.0f * p2 - 3.0f * p3 + p4;
+    auto b = 3.0f * p1 - 6.0f * p2 + 3.0f * p3;
+    auto c = -3.0f * p1 + 3.0f * p2;
+
+    auto h = 1.0f / float(segments);
+    auto h2 = h * h;
+    auto h3 = h2 * h;
+
+    auto fd1 = a * h3 + b * h2 + c * h;
+    auto fd2 = 6.0f * a * h3 + 2.0f * b * h2;
+    auto fd3 = 6.0f * a * h3;
+
+    auto pt = p1;
+    for (int i = 1; i < segments; i++)
     {
-        float x12 = (x1 + x2) * 0.5f, y12 = (y1 + y2) * 0.5f;
-        float x23 = (x2 + x3) * 0.5f, y23 = (y2 + y3) * 0.5f;
-        float x34 = (x3 + x4) * 0.5f, y34 = (y3 + y4) * 0.5f;
-        float x123 = (x12 + x23) * 0.5f, y123 = (y12 + y23) * 0.5f;
-        float x234 = (x23 + x34) * 0.5f, y234 = (y23 + y34) * 0.5f;
-        float x1234 = (x123 + x234) * 0.5f, y1234 = (y123 + y234) * 0.5f;
-        CubicBezier(path, x1, y1, x12, y12, x123, y123, x1234, y1234, tess_tol, level + 1);
-        CubicBezier(path, x1234, y1234, x234, y234, x34, y34, x4, y4, tess_tol, level + 1);
+        pt += fd1;
+        fd1 += fd2;
+        fd2 += fd3;
+        path.push_back(pt);
     }
+
+    // Land exactly on the end point, whatever the accumulated error
+    path.push_back(p4);
 }
 
 void Canvas::DrawCubicBezier(const glm::vec2& p1, const glm::vec2& p2, const glm::vec2& p3, const glm::vec2& p4, const glm::vec4& color, float width)
 {
+    // When the control points are only a few pixels off the chord, the curve is drawn as a straight line
+    if (!IsDetailVisible(CurveDeviation(p1, p2, p3, p4), GetTheme().lodCableCurvePixels))
+    {
+        DrawLine(p1, p4, color, width);
+        return;
+    }
+
     pointStorage.clear();
     pointStorage.push_back(p1);
-    CubicBezier(pointStorage, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, 0.1f, 0);
+    CubicBezier(pointStorage, p1, p2, p3, p4, BezierPixelTolerance);
 
-    BeginStroke(pointStorage[0], width, color);
-    for (int i = 1; i < pointStorage.size(); i++)
-    {
-        LineTo(pointStorage[i]);
-    }
-    EndStroke();
+    Polyline(pointStorage, width, color);
 
     /*
     BeginStroke(p1, 2.0f, glm::vec4(1.0f));
@@ -246,27 +554,425 @@ void Canvas::DrawCubicBezier(const glm::vec2& p1, const glm::vec2& p2, const glm
     */
 }
 
+void Canvas::DrawCables(std::span<const CableDesc> cables)
+{
+    // Captured as they are described, so that culling and tessellation happen for the view they are replayed at
+    if (m_pCapture)
+    {
+        if (!cables.empty())
+        {
+            m_pCapture->Cables(cables);
+        }
+        return;
+    }
+
+    auto straightPixels = GetTheme().lodCableCurvePixels;
+
+    // Every cable goes into the one point stream
+    pointStorage.clear();
+    m_cableRuns.clear();
+    for (auto& cable : cables)
+    {
+        auto p1 = cable.from;
+        auto p2 = cable.from + cable.fromTangent;
+        auto p3 = cable.to + cable.toTangent;
+        auto p4 = cable.to;
+
+        // The curve lies inside the hull of its control points
+        auto hullMin = glm::min(glm::min(p1, p2), glm::min(p3, p4)) - glm::vec2(cable.width);
+        auto hullMax = glm::max(glm::max(p1, p2), glm::max(p3, p4)) + glm::vec2(cable.width);
+        if (!IsVisible(NRectf(hullMin, hullMax)))
+        {
+            continue;
+        }
+
+        PolylineRun run;
+        run.offset = uint32_t(pointStorage.size());
+        run.color = cable.color;
+        run.width = cable.width;
+
+        pointStorage.push_back(p1);
+        if (IsDetailVisible(CurveDeviation(p1, p2, p3, p4), straightPixels))
+        {
+            CubicBezier(pointStorage, p1, p2, p3, p4, BezierPixelTolerance);
+        }
+        else
+        {
+            pointStorage.push_back(p4);
+        }
+
+        run.count = uint32_t(pointStorage.size()) - run.offset;
+        m_cableRuns.push_back(run);
+    }
+
+    SubmitPolylines(pointStorage, m_cableRuns);
+}
+
+void Canvas::SubmitPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs)
+{
+    if (runs.empty())
+    {
+        return;
+    }
+
+    if (m_pCapture)
+    {
+        m_pCapture->Polylines(points, runs);
+        return;
+    }
+    OnPolylines(points, runs);
+}
+
+void Canvas::OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs)
+{
+    for (auto& run : runs)
+    {
+        OnPolyline(points.subspan(run.offset, run.count), run.width, run.color, false);
+    }
+}
+
+void Canvas::Slab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->Slab(rc, radius, shadowSize, shadowColor, borderSize, borderColor, centerColor);
+        return;
+    }
+    OnSlab(rc, radius, shadowSize, shadowColor, borderSize, borderColor, centerColor);
+}
+
+void Canvas::OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor)
+{
+    if (shadowColor.w > 0.0f)
+    {
+        auto shadowRect = rc;
+        shadowRect.Adjust(shadowSize, shadowSize);
+        OnFillRoundedRect(shadowRect, radius, shadowColor);
+    }
+
+    auto centerRect = rc;
+    if (borderSize != 0.0f)
+    {
+        OnFillRoundedRect(rc, radius, borderColor);
+        centerRect.Adjust(borderSize, borderSize, -borderSize, -borderSize);
+    }
+    OnFillRoundedRect(centerRect, radius, centerColor);
+}
+
 bool Canvas::HasGradientVarying() const
 {
     return true;
 }
 
+void Canvas::FilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->FilledCircle(center, radius, color);
+        return;
+    }
+    OnFilledCircle(center, radius, color);
+}
+
+void Canvas::FilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->FilledGradientCircle(center, radius, gradientRange, startColor, endColor);
+        return;
+    }
+    OnFilledGradientCircle(center, radius, gradientRange, startColor, endColor);
+}
+
+void Canvas::FillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->FillRoundedRect(rc, radius, color);
+        return;
+    }
+    OnFillRoundedRect(rc, radius, color);
+}
+
+void Canvas::FillRect(const NRectf& rc, const glm::vec4& color)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->FillRect(rc, color);
+        return;
+    }
+    OnFillRect(rc, color);
+}
+
+void Canvas::FillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->FillGradientRoundedRect(rc, radius, gradientRange, startColor, endColor);
+        return;
+    }
+    OnFillGradientRoundedRect(rc, radius, gradientRange, startColor, endColor);
+}
+
+void Canvas::FillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->FillGradientRoundedRectVarying(rc, radius, gradientRange, startColor, endColor);
+        return;
+    }
+    OnFillGradientRoundedRectVarying(rc, radius, gradientRange, startColor, endColor);
+}
+
+void Canvas::Stroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->Stroke(from, to, width, color);
+        return;
+    }
+    OnStroke(from, to, width, color);
+}
+
+void Canvas::Arc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->Arc(pos, radius, width, color, startAngle, endAngle);
+        return;
+    }
+    OnArc(pos, radius, width, color, startAngle, endAngle);
+}
+
+void Canvas::SetAA(bool set)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->SetAA(set);
+        return;
+    }
+    OnSetAA(set);
+}
+
+void Canvas::BeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->BeginStroke(from, width, color);
+        return;
+    }
+    OnBeginStroke(from, width, color);
+}
+
+void Canvas::BeginPath(const glm::vec2& from, const glm::vec4& color)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->BeginPath(from, color);
+        return;
+    }
+    OnBeginPath(from, color);
+}
+
+void Canvas::MoveTo(const glm::vec2& to)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->MoveTo(to);
+        return;
+    }
+    OnMoveTo(to);
+}
+
+void Canvas::LineTo(const glm::vec2& to)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->LineTo(to);
+        return;
+    }
+    OnLineTo(to);
+}
+
+void Canvas::SetLineCap(LineCap cap)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->SetLineCap(cap);
+        return;
+    }
+    OnSetLineCap(cap);
+}
+
+void Canvas::ClosePath()
+{
+    if (m_pCapture)
+    {
+        m_pCapture->ClosePath();
+        return;
+    }
+    OnClosePath();
+}
+
+void Canvas::EndPath()
+{
+    if (m_pCapture)
+    {
+        m_pCapture->EndPath();
+        return;
+    }
+    OnEndPath();
+}
+
+void Canvas::EndStroke()
+{
+    if (m_pCapture)
+    {
+        m_pCapture->EndStroke();
+        return;
+    }
+    OnEndStroke();
+}
+
+void Canvas::Polyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed)
+{
+    if (points.size() < 2)
+    {
+        return;
+    }
+
+    if (m_pCapture)
+    {
+        m_pCapture->Polyline(points, width, color, closed);
+        return;
+    }
+    OnPolyline(points, width, color, closed);
+}
+
+void Canvas::FillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color)
+{
+    if (points.size() < 3)
+    {
+        return;
+    }
+
+    if (m_pCapture)
+    {
+        m_pCapture->FillConvexPolygon(points, color);
+        return;
+    }
+    OnFillConvexPolygon(points, color);
+}
+
+void Canvas::Text(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->Text(pos, size, color, pszText, pszFace, align);
+        return;
+    }
+    OnText(pos, size, color, pszText, pszFace, align);
+}
+
+void Canvas::TextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    if (m_pCapture)
+    {
+        m_pCapture->TextBox(pos, size, breakWidth, color, pszText, pszFace, align);
+        return;
+    }
+    OnTextBox(pos, size, breakWidth, color, pszText, pszFace, align);
+}
+
+void Canvas::BeginCapture(DrawList& drawList)
+{
+    assert(!m_pCapture);
+    drawList.Clear();
+    m_pCapture = &drawList;
+}
+
+void Canvas::EndCapture()
+{
+    assert(m_pCapture);
+    m_pCapture = nullptr;
+}
+
+bool Canvas::IsCapturing() const
+{
+    return m_pCapture != nullptr;
+}
+
+void Canvas::BeginFrame()
+{
+    m_frameArena.Reset();
+    m_tips.Tick();
+
+    // A different theme changes every recorded color, not just the cached values
+    if (m_themeValid && Zest::GlobalSettingsManager::Instance().GetCurrentTheme() != m_themeId)
+    {
+        InvalidateDrawCache();
+    }
+}
+
+FrameArena& Canvas::GetFrameArena()
+{
+    return m_frameArena;
+}
+
+TipScheduler& Canvas::GetTipScheduler()
+{
+    return m_tips;
+}
+
+const ThemeCache& Canvas::GetTheme()
+{
+    if (!m_themeValid)
+    {
+        m_themeId = Zest::GlobalSettingsManager::Instance().GetCurrentTheme();
+        m_theme.Resolve(m_themeId);
+        m_themeValid = true;
+    }
+    return m_theme;
+}
+
+void Canvas::InvalidateDrawCache()
+{
+    m_drawCacheGeneration++;
+    m_themeValid = false;
+    RequestRedraw();
+}
+
+// Widgets mark their parents dirty all the way up, so a dirty root layout means something below it changed
+bool Canvas::NeedsRedraw() const
+{
+    if (m_redrawRequested || m_spRootLayout->IsDirty())
+    {
+        return true;
+    }
+
+    // A tip that is waiting, fading in or fading out changes with time alone
+    return m_tips.IsAnimating();
+}
+
+void Canvas::RequestRedraw()
+{
+    m_redrawRequested = true;
+}
+
 void Canvas::HandleMouseDown(CanvasInputState& input)
 {
-    const auto& search = GetRootLayout()->GetFrontToBack();
-    for (auto& pWidget : search)
+    // Only the widgets under the mouse, front to back
+    m_spSpatialGrid->Query(input.worldMousePos, m_hitCandidates);
+    for (auto& pWidget : m_hitCandidates)
     {
-        if (pWidget->GetWorldRect().Contains(input.worldMousePos))
+        if (auto pCapture = pWidget->MouseDown(input))
         {
-            if (auto pCapture = pWidget->MouseDown(input))
-            {
-                input.m_pMouseCapture = pCapture;
-                pCapture->GetTipTimer().SetState(TipState::On);
+            input.m_pMouseCapture = pCapture;
+            pCapture->GetTipTimer().SetState(TipState::On, m_tips);
 
-                // Draw the recently clicked one last
-                GetRootLayout()->MoveChildToBack(pWidget);
-                return;
-            }
+            // Draw the recently clicked one last
+            GetRootLayout()->MoveChildToBack(pWidget);
+            return;
         }
     }
 }
@@ -277,6 +983,7 @@ void Canvas::HandleMouseUp(CanvasInputState& input)
     {
         // Setup the hover event
         input.m_pMouseCapture->MouseUp(input);
+        input.m_pMouseCapture->MarkDirty();
         input.m_pMouseCapture = nullptr;
         return;
     }
@@ -286,42 +993,41 @@ void Canvas::HandleMouseMove(CanvasInputState& input)
 {
     if (!input.m_pMouseCapture)
     {
-        const auto& search = GetRootLayout()->GetFrontToBack();
+        m_spSpatialGrid->Query(input.worldMousePos, m_hitCandidates);
+
         Widget* pHoverWidget = nullptr;
-        for (auto& pWidget : search)
+        for (auto& pWidget : m_hitCandidates)
         {
-            if (pWidget->GetWorldRect().Contains(input.worldMousePos))
+            if (auto pCapture = pWidget->MouseHover(input))
             {
-                if (auto pCapture = pWidget->MouseHover(input))
-                {
-                    pHoverWidget = pCapture;
-                    break;
-                }
+                pHoverWidget = pCapture;
+                break;
             }
         }
        
-        auto active = TipTimer::ActiveTips;
-        for (auto& [pWidget, pTip] : active)
+        // Stopping a tip can take it out of the active list, so step past it first
+        auto pTip = m_tips.GetFirstActive();
+        while (pTip)
         {
-            if (pWidget != pHoverWidget)
+            auto pNext = pTip->GetNextActive();
+            if (pTip->GetOwner() != pHoverWidget)
             {
-                pWidget->GetTipTimer().Stop();
+                pTip->Stop(m_tips);
             }
+            pTip = pNext;
         }
 
         if (pHoverWidget)
         {
-            pHoverWidget->GetTipTimer().Start();
+            pHoverWidget->GetTipTimer().Start(m_tips);
         }
 
-        for (auto& pWidget : m_spRootLayout->GetFrontToBack())
+        // Nothing is captured, so nothing has moved since the query
+        for (auto& pWidget : m_hitCandidates)
         {
-            if (pWidget->GetWorldRect().Contains(input.worldMousePos))
+            if (pWidget->MouseMove(input))
             {
-                if (pWidget->MouseMove(input))
-                {
-                    return;
-                }
+                return;
             }
         }
     }
@@ -331,12 +1037,124 @@ void Canvas::HandleMouseMove(CanvasInputState& input)
     }
 }
 
+// Each top level widget records its commands into its own cache, and only re-records when it is dirty
+// or the cache is stale; otherwise the cached list is just replayed to the backend.
 void Canvas::Draw()
 {
-    for (auto& pWidget : m_spRootLayout->GetBackToFront())
+    m_redrawRequested = false;
+
+    // Some widgets (slider thumbs) size themselves in pixels, so zooming needs a fresh recording.
+    // This frame is the redraw, so the generation is bumped without requesting another one.
+    if (m_worldScale != m_drawCacheScale)
+    {
+        m_drawCacheScale = m_worldScale;
+        m_drawCacheGeneration++;
+    }
+
+    // Tips animate over time, so their owners can't use the cached commands
+    for (auto pTip = m_tips.GetFirstActive(); pTip; pTip = pTip->GetNextActive())
+    {
+        pTip->GetOwner()->MarkDirty();
+    }
+
+    auto visibleRect = GetVisibleWorldRect();
+    m_drawWidgets.clear();
+    m_recordWidgets.clear();
+    for (auto& spWidget : m_spRootLayout->GetBackToFront())
+    {
+        // Off screen widgets are skipped entirely, along with all of their children
+        auto pWidget = spWidget.get();
+        if (!IsVisible(pWidget->GetWorldRect()))
+        {
+            continue;
+        }
+        m_drawWidgets.push_back(pWidget);
+
+        auto& drawList = pWidget->GetDrawCache();
+        if (pWidget->IsDirty() || drawList.GetGeneration() != m_drawCacheGeneration || !drawList.IsValidForView(visibleRect))
+        {
+            m_recordWidgets.push_back(pWidget);
+        }
+    }
+
+    RecordWidgets(visibleRect);
+
+    // Each widget has its own list, so replaying them back to front merges them in z order
+    for (auto pWidget : m_drawWidgets)
     {
-        pWidget->Draw(*this);
+        pWidget->GetDrawCache().Replay(*this);
     }
+
+    // Everything visible has been recorded; off screen widgets keep their own flags until they come into view
+    m_spRootLayout->ClearDirty();
+}
+
+void Canvas::RecordWidget(Widget* pWidget, const NRectf& visibleRect)
+{
+    auto& drawList = pWidget->GetDrawCache();
+    m_captureCulled = false;
+
+    BeginCapture(drawList);
+    pWidget->Draw(*this);
+    EndCapture();
+
+    if (m_captureCulled)
+    {
+        drawList.SetViewDependent(visibleRect);
+    }
+    drawList.SetGeneration(m_drawCacheGeneration);
+    pWidget->ClearDirty();
+}
+
+// Top level widgets only touch their own subtree while they record, apart from the root above them
+// and what is shared through the canvas; the root queues their notices until the pass is over, and
+// the rest is copied to each worker
+void Canvas::RecordWidgets(const NRectf& visibleRect)
+{
+    if (!m_spRecordPool || m_recordWidgets.size() < MinParallelRecordWidgets)
+    {
+        for (auto pWidget : m_recordWidgets)
+        {
+            RecordWidget(pWidget, visibleRect);
+        }
+        return;
+    }
+
+    // Resolve anything lazy that the workers would otherwise race to fill in
+    GetTheme();
+    m_spRootLayout->GetWorldRect();
+    for (auto& spWorker : m_recordWorkers)
+    {
+        spWorker->Sync();
+    }
+
+    m_spRootLayout->SetHoldNotifications(true);
+    m_spRecordPool->Run(m_recordWidgets.size(), [&](size_t item, uint32_t worker) {
+        Canvas& recorder = *m_recordWorkers[worker];
+        recorder.RecordWidget(m_recordWidgets[item], visibleRect);
+    });
+    m_spRootLayout->SetHoldNotifications(false);
+}
+
+void Canvas::SetRecordThreads(uint32_t threadCount)
+{
+    m_recordWorkers.clear();
+    m_spRecordPool.reset();
+    if (threadCount <= 1)
+    {
+        return;
+    }
+
+    m_spRecordPool = std::make_unique<WorkerPool>(threadCount);
+    for (uint32_t i = 0; i < m_spRecordPool->GetWorkerCount(); i++)
+    {
+        m_recordWorkers.push_back(std::make_unique<RecordWorker>(*this));
+    }
+}
+
+uint32_t Canvas::GetRecordThreads() const
+{
+    return m_spRecordPool ? m_spRecordPool->GetWorkerCount() : 1;
 }
 
 Layout* Canvas::GetRootLayout() const
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <array>
 #include <filesystem>
 
 #include <zest/math/math_utils.h>
@@ -10,9 +12,81 @@
 
 namespace fs = std::filesystem;
 
+// Pixel points are written as glm::vec2 and handed to ImGui as they are
+static_assert(sizeof(ImVec2) == sizeof(glm::vec2));
+
 namespace {
-const int CircleSegments = 40;
-const int ArcSegments = 40;
+const float CurveTolerance = 0.25f; // Max pixel distance between a chord and its circle
+const int MinCircleSegments = 8;
+const int MaxCircleSegments = 128;
+const int CircleSegmentStep = 4; // Segment counts are rounded up to a multiple of this, to share tables
+const float SlabCornerDetail = 0.5f; // Corner segments per pixel of radius
+const int MaxSlabCornerSegments = 12;
+
+// Segments for a full circle of this pixel radius, keeping every chord within tolerance
+int circle_segments(float radius)
+{
+    auto segments = MinCircleSegments;
+    if (radius > CurveTolerance)
+    {
+        auto step = 2.0f * std::acos(1.0f - CurveTolerance / radius);
+        segments = int(std::ceil(glm::two_pi<float>() / step));
+    }
+    segments = (segments + CircleSegmentStep - 1) / CircleSegmentStep * CircleSegmentStep;
+    return std::clamp(segments, MinCircleSegments, MaxCircleSegments);
+}
+
+// Unit circle points for each segment count, built once
+const std::vector<glm::vec2>& unit_circle(int segments)
+{
+    static const auto tables = []() {
+        std::array<std::vector<glm::vec2>, MaxCircleSegments / CircleSegmentStep + 1> result;
+        for (int count = CircleSegmentStep; count <= MaxCircleSegments; count += CircleSegmentStep)
+        {
+            auto& table = result[count / CircleSegmentStep];
+            table.resize(count);
+            for (int i = 0; i < count; i++)
+            {
+                auto angle = glm::two_pi<float>() * float(i) / float(count);
+                table[i] = glm::vec2(std::cos(angle), std::sin(angle));
+            }
+        }
+        return result;
+    }();
+    return tables[segments / CircleSegmentStep];
+}
+
+void path_circle(ImDrawList* pDraw, const glm::vec2& center, float radius)
+{
+    for (auto& dir : unit_circle(circle_segments(radius)))
+    {
+        pDraw->PathLineTo(center + dir * radius);
+    }
+}
+
+// The exact end points, with the table points that fall between them; angles in radians
+void path_arc(ImDrawList* pDraw, const glm::vec2& center, float radius, float startAngle, float endAngle)
+{
+    auto& table = unit_circle(circle_segments(radius));
+    auto count = int(table.size());
+    auto step = glm::two_pi<float>() / float(count);
+
+    pDraw->PathLineTo(center + glm::vec2(std::cos(startAngle), std::sin(startAngle)) * radius);
+
+    auto forward = endAngle >= startAngle;
+    auto index = forward ? int(std::floor(startAngle / step)) + 1 : int(std::ceil(startAngle / step)) - 1;
+    for (int i = 0; i < count; i++, index += forward ? 1 : -1)
+    {
+        auto angle = float(index) * step;
+        if (forward ? angle >= endAngle : angle <= endAngle)
+        {
+            break;
+        }
+        pDraw->PathLineTo(center + table[((index % count) + count) % count] * radius);
+    }
+
+    pDraw->PathLineTo(center + glm::vec2(std::cos(endAngle), std::sin(endAngle)) * radius);
+}
 }
 
 namespace NodeGraph {
@@ -36,6 +110,7 @@ CanvasImGui::CanvasImGui(IFontTexture* pFontTexture, float worldScale, const glm
 
 void CanvasImGui::Begin(const glm::vec4& clearColor)
 {
+    BeginFrame();
     fonts_begin_frame(*spFontContext);
 
     origin = ImGui::GetCursorScreenPos();
@@ -54,17 +129,19 @@ void CanvasImGui::End()
     fonts_end_frame(*spFontContext);
 }
 
-void CanvasImGui::FilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
+void CanvasImGui::OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
 {
     auto worldCenter = WorldToPixels(center);
     auto worldRadius = WorldSizeToPixelSize(radius);
     worldCenter += glm::vec2(origin);
 
     auto pDraw = ImGui::GetWindowDrawList();
-    pDraw->AddCircleFilled(worldCenter, worldRadius, ToImColor(color), CircleSegments);
+    pDraw->PathClear();
+    path_circle(pDraw, worldCenter, worldRadius);
+    pDraw->PathFillConvex(ToImColor(color));
 }
 
-void CanvasImGui::FilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+void CanvasImGui::OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
 {
     auto worldCenter = WorldToPixels(center);
     auto worldRadius = WorldSizeToPixelSize(radius);
@@ -74,10 +151,12 @@ void CanvasImGui::FilledGradientCircle(const glm::vec2& center, float radius, co
 
     // TODO: Should be gradient but can't do it on ImGui yet
     auto pDraw = ImGui::GetWindowDrawList();
-    pDraw->AddCircleFilled(worldCenter, worldRadius, ToImColor(startColor), CircleSegments);
+    pDraw->PathClear();
+    path_circle(pDraw, worldCenter, worldRadius);
+    pDraw->PathFillConvex(ToImColor(startColor));
 }
 
-void CanvasImGui::Stroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+void CanvasImGui::OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
 {
     auto worldFrom = WorldToPixels(from);
     auto worldTo = WorldToPixels(to);
@@ -90,7 +169,7 @@ void CanvasImGui::Stroke(const glm::vec2& from, const glm::vec2& to, float width
     pDraw->AddLine(worldFrom, worldTo, ToImColor(color), worldWidth);
 }
 
-void CanvasImGui::FillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
+void CanvasImGui::OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
 {
     auto worldRect = WorldToPixels(rc);
     auto worldSize = WorldSizeToPixelSize(radius);
@@ -100,7 +179,7 @@ void CanvasImGui::FillRoundedRect(const NRectf& rc, float radius, const glm::vec
     pDraw->AddRectFilled(worldRect.topLeftPx, worldRect.bottomRightPx, ToImColor(color), worldSize);
 }
 
-void CanvasImGui::FillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+void CanvasImGui::OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
 {
     auto worldRect = WorldToPixels(rc);
     auto worldSize = WorldSizeToPixelSize(radius);
@@ -113,7 +192,7 @@ void CanvasImGui::FillGradientRoundedRect(const NRectf& rc, float radius, const
     pDraw->AddRectFilled(worldRect.topLeftPx, worldRect.bottomRightPx, ToImColor(startColor), worldSize);
 }
 
-void CanvasImGui::FillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+void CanvasImGui::OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
 {
     auto worldRect = WorldToPixels(rc);
     float worldSize0 = 0.0f;
@@ -148,7 +227,7 @@ void CanvasImGui::FillGradientRoundedRectVarying(const NRectf& rc, const glm::ve
     pDraw->AddRectFilled(worldRect.topLeftPx, worldRect.bottomRightPx, ToImColor(startColor), worldSize0, flags);
 }
 
-void CanvasImGui::FillRect(const NRectf& rc, const glm::vec4& color)
+void CanvasImGui::OnFillRect(const NRectf& rc, const glm::vec4& color)
 {
     auto worldRect = WorldToPixels(rc);
     auto pDraw = ImGui::GetWindowDrawList();
@@ -180,7 +259,7 @@ NRectf CanvasImGui::TextBounds(const glm::vec2& pos, float size, const char* psz
     return NRectf(pos.x, pos.y, PixelSizeToWorldSize(width) * m_worldScale, PixelSizeToWorldSize(size));
 }
 
-void CanvasImGui::Text(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+void CanvasImGui::OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
 {
     auto worldPos = WorldToPixels(pos);
     worldPos += glm::vec2(origin);
@@ -202,7 +281,7 @@ void CanvasImGui::Text(const glm::vec2& pos, float size, const glm::vec4& color,
     fonts_draw_text(*spFontContext, worldPos.x / m_worldScale, worldPos.y / m_worldScale, packedColor, pszText, nullptr);
 }
 
-void CanvasImGui::TextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+void CanvasImGui::OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
 {
     auto worldPos = WorldToPixels(pos);
     worldPos += glm::vec2(origin);
@@ -222,7 +301,7 @@ void CanvasImGui::TextBox(const glm::vec2& pos, float size, float breakWidth, co
     fonts_text_box(*spFontContext, worldPos.x / m_worldScale, worldPos.y / m_worldScale, breakWidth, glm::packUnorm4x8(color), pszText, nullptr);
 }
 
-void CanvasImGui::Arc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
+void CanvasImGui::OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
 {
     auto worldRadius = WorldSizeToPixelSize(radius);
     auto worldPos = WorldToPixels(pos);
@@ -232,17 +311,17 @@ void CanvasImGui::Arc(const glm::vec2& pos, float radius, float width, const glm
 
     auto pDraw = ImGui::GetWindowDrawList();
     pDraw->PathClear();
-    pDraw->PathArcTo(worldPos, worldRadius, Zest::degToRad(startAngle), Zest::degToRad(endAngle), ArcSegments);
+    path_arc(pDraw, worldPos, worldRadius, Zest::degToRad(startAngle), Zest::degToRad(endAngle));
     pDraw->PathStroke(ToImColor(color), false, worldWidth);
 }
 
-void CanvasImGui::SetAA(bool set)
+void CanvasImGui::OnSetAA(bool set)
 {
     /* Nothing currently */
     M_UNUSED(set);
 }
 
-void CanvasImGui::BeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
+void CanvasImGui::OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
 {
     auto worldPos = WorldToPixels(from);
     auto size = WorldSizeToPixelSize(width);
@@ -258,7 +337,7 @@ void CanvasImGui::BeginStroke(const glm::vec2& from, float width, const glm::vec
     m_closePath = false;
 }
 
-void CanvasImGui::BeginPath(const glm::vec2& from, const glm::vec4& color)
+void CanvasImGui::OnBeginPath(const glm::vec2& from, const glm::vec4& color)
 {
     auto worldPos = WorldToPixels(from);
     worldPos += glm::vec2(origin);
@@ -270,7 +349,7 @@ void CanvasImGui::BeginPath(const glm::vec2& from, const glm::vec4& color)
     m_closePath = false;
 }
 
-void CanvasImGui::LineTo(const glm::vec2& to)
+void CanvasImGui::OnLineTo(const glm::vec2& to)
 {
     auto worldPos = WorldToPixels(to);
     worldPos += glm::vec2(origin);
@@ -279,7 +358,7 @@ void CanvasImGui::LineTo(const glm::vec2& to)
     pDraw->PathLineTo(worldPos);
 }
 
-void CanvasImGui::MoveTo(const glm::vec2& to)
+void CanvasImGui::OnMoveTo(const glm::vec2& to)
 {
     auto worldPos = WorldToPixels(to);
     worldPos += glm::vec2(origin);
@@ -289,19 +368,225 @@ void CanvasImGui::MoveTo(const glm::vec2& to)
     pDraw->PathLineTo(worldPos);
 }
 
-void CanvasImGui::EndStroke()
+void CanvasImGui::OnEndStroke()
 {
     auto pDraw = ImGui::GetWindowDrawList();
     pDraw->PathStroke(m_pathColor, m_closePath, m_pathWidth);
 }
 
-void CanvasImGui::EndPath()
+void CanvasImGui::OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed)
+{
+    // One transform pass, then a single draw list call for the whole line
+    m_polylinePoints.resize(points.size());
+    WorldPointsToPixels(points, m_polylinePoints.data(), glm::vec2(origin));
+
+    auto pDraw = ImGui::GetWindowDrawList();
+    pDraw->AddPolyline(reinterpret_cast<const ImVec2*>(m_polylinePoints.data()), int(m_polylinePoints.size()), ToImColor(color), closed ? ImDrawFlags_Closed : ImDrawFlags_None, WorldSizeToPixelSize(width));
+}
+
+void CanvasImGui::OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color)
+{
+    m_polylinePoints.resize(points.size());
+    WorldPointsToPixels(points, m_polylinePoints.data(), glm::vec2(origin));
+
+    auto pDraw = ImGui::GetWindowDrawList();
+    pDraw->AddConvexPolyFilled(reinterpret_cast<const ImVec2*>(m_polylinePoints.data()), int(m_polylinePoints.size()), ToImColor(color));
+}
+
+// Cables are written straight into the draw list as triangle strips, so thousands of them end up in
+// the same vertex buffer and draw command instead of going through the path API one at a time.
+// Like the slab, each side of the strip gets a half pixel transparent fringe for anti-aliasing.
+void CanvasImGui::OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs)
+{
+    auto pDraw = ImGui::GetWindowDrawList();
+    auto uv = ImGui::GetFontTexUvWhitePixel();
+
+    auto safeNormalize = [](const glm::vec2& v, const glm::vec2& fallback) {
+        auto len = glm::length(v);
+        return len > 0.0001f ? v / len : fallback;
+    };
+
+    for (auto& run : runs)
+    {
+        if (run.count < 2)
+        {
+            continue;
+        }
+
+        auto color = ToImColor(run.color);
+        auto fringeColor = ToImColor(glm::vec4(run.color.x, run.color.y, run.color.z, 0.0f));
+        auto halfWidth = std::max(WorldSizeToPixelSize(run.width), 1.0f) * 0.5f;
+        auto coreWidth = std::max(halfWidth - 0.5f, 0.0f);
+        auto fringeWidth = halfWidth + 0.5f;
+
+        // The run in pixels, once, and the strip is built from those
+        m_polylinePoints.resize(run.count);
+        WorldPointsToPixels(points.subspan(run.offset, run.count), m_polylinePoints.data(), glm::vec2(origin));
+        auto& line = m_polylinePoints;
+
+        // Reserve per run; ImGui moves to a new vertex offset here if 16 bit indices would overflow
+        pDraw->PrimReserve(int(line.size() - 1) * 18, int(line.size()) * 4);
+        auto baseIndex = pDraw->_VtxCurrentIdx;
+
+        // Four vertices across each point; fringe, core, core, fringe
+        auto dir = safeNormalize(line[1] - line[0], glm::vec2(1.0f, 0.0f));
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            auto nextDir = (i + 1 < line.size()) ? safeNormalize(line[i + 1] - line[i], dir) : dir;
+
+            // Mitre the join, but don't let sharp bends spike out
+            auto tangent = safeNormalize(dir + nextDir, nextDir);
+            auto normal = glm::vec2(-tangent.y, tangent.x);
+            normal /= std::max(glm::dot(normal, glm::vec2(-nextDir.y, nextDir.x)), 0.5f);
+
+            auto& pos = line[i];
+            pDraw->PrimWriteVtx(pos + normal * fringeWidth, uv, fringeColor);
+            pDraw->PrimWriteVtx(pos + normal * coreWidth, uv, color);
+            pDraw->PrimWriteVtx(pos - normal * coreWidth, uv, color);
+            pDraw->PrimWriteVtx(pos - normal * fringeWidth, uv, fringeColor);
+            dir = nextDir;
+        }
+
+        for (uint32_t i = 0; i < uint32_t(line.size() - 1); i++)
+        {
+            // Three quads between this point and the next; the outer fringe, the core and the inner fringe
+            auto idx = ImDrawIdx(baseIndex + i * 4);
+            for (uint32_t quad = 0; quad < 3; quad++)
+            {
+                auto a = ImDrawIdx(idx + quad);
+                auto b = ImDrawIdx(idx + quad + 4);
+                pDraw->PrimWriteIdx(a);
+                pDraw->PrimWriteIdx(ImDrawIdx(a + 1));
+                pDraw->PrimWriteIdx(b);
+                pDraw->PrimWriteIdx(ImDrawIdx(a + 1));
+                pDraw->PrimWriteIdx(ImDrawIdx(b + 1));
+                pDraw->PrimWriteIdx(b);
+            }
+        }
+    }
+}
+
+// The shadow, border and centre as a single mesh. Every outline has the same number of points, so
+// neighbouring outlines are stitched together index for index; the border is a ring around the centre
+// rather than a rect underneath it, and each edge gets a one pixel fringe for anti-aliasing.
+void CanvasImGui::OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor)
+{
+    auto pDraw = ImGui::GetWindowDrawList();
+    auto uv = ImGui::GetFontTexUvWhitePixel();
+
+    auto pixelRect = WorldToPixels(rc);
+    auto topLeft = glm::min(pixelRect.topLeftPx, pixelRect.bottomRightPx) + glm::vec2(origin);
+    auto bottomRight = glm::max(pixelRect.topLeftPx, pixelRect.bottomRightPx) + glm::vec2(origin);
+    auto pixelBorder = borderSize != 0.0f ? WorldSizeToPixelSize(borderSize) : 0.0f;
+    auto shadowOffset = glm::vec2(WorldSizeToPixelSize(shadowSize));
+    auto drawShadow = shadowColor.w > 0.0f;
+
+    auto clampRadius = [](const glm::vec2& tl, const glm::vec2& br, float r) {
+        return std::clamp(r, 0.0f, std::min(br.x - tl.x, br.y - tl.y) * 0.5f);
+    };
+    auto outerRadius = clampRadius(topLeft, bottomRight, WorldSizeToPixelSize(radius));
+    auto innerTopLeft = topLeft + pixelBorder;
+    auto innerBottomRight = glm::max(bottomRight - pixelBorder, innerTopLeft);
+    auto innerRadius = clampRadius(innerTopLeft, innerBottomRight, WorldSizeToPixelSize(radius));
+
+    // Unit directions around the corners; top left, top right, bottom right, bottom left
+    std::array<glm::vec2, (MaxSlabCornerSegments + 1) * 4> directions;
+    auto cornerSegments = std::clamp(int(std::ceil(outerRadius * SlabCornerDetail)), 1, MaxSlabCornerSegments);
+    auto outlineCount = (cornerSegments + 1) * 4;
+    for (int corner = 0; corner < 4; corner++)
+    {
+        for (int i = 0; i <= cornerSegments; i++)
+        {
+            auto angle = glm::pi<float>() * (1.0f + 0.5f * (float(corner) + float(i) / float(cornerSegments)));
+            directions[corner * (cornerSegments + 1) + i] = glm::vec2(std::cos(angle), std::sin(angle));
+        }
+    }
+
+    auto rings = (drawShadow ? 2 : 0) + (pixelBorder > 0.0f ? 4 : 2);
+    auto stitches = (drawShadow ? 1 : 0) + (pixelBorder > 0.0f ? 3 : 1);
+    auto fans = drawShadow ? 2 : 1;
+    pDraw->PrimReserve(stitches * outlineCount * 6 + fans * (outlineCount - 2) * 3, rings * outlineCount);
+    auto baseIndex = pDraw->_VtxCurrentIdx;
+
+    // An outline grown outwards by 'grow' pixels; corner centres stay put until the radius runs out
+    uint32_t ringCount = 0;
+    auto writeRing = [&](const glm::vec2& tl, const glm::vec2& br, float r, float grow, const glm::vec4& color) {
+        auto grownRadius = std::max(r + grow, 0.0f);
+        glm::vec2 centers[4] = {
+            glm::vec2(tl.x - grow + grownRadius, tl.y - grow + grownRadius),
+            glm::vec2(br.x + grow - grownRadius, tl.y - grow + grownRadius),
+            glm::vec2(br.x + grow - grownRadius, br.y + grow - grownRadius),
+            glm::vec2(tl.x - grow + grownRadius, br.y + grow - grownRadius)
+        };
+
+        auto imColor = ToImColor(color);
+        for (int i = 0; i < outlineCount; i++)
+        {
+            pDraw->PrimWriteVtx(centers[i / (cornerSegments + 1)] + directions[i] * grownRadius, uv, imColor);
+        }
+        return ImDrawIdx(baseIndex + outlineCount * ringCount++);
+    };
+
+    auto stitch = [&](ImDrawIdx outer, ImDrawIdx inner) {
+        for (int i = 0; i < outlineCount; i++)
+        {
+            auto next = (i + 1) % outlineCount;
+            pDraw->PrimWriteIdx(ImDrawIdx(outer + i));
+            pDraw->PrimWriteIdx(ImDrawIdx(outer + next));
+            pDraw->PrimWriteIdx(ImDrawIdx(inner + next));
+            pDraw->PrimWriteIdx(ImDrawIdx(outer + i));
+            pDraw->PrimWriteIdx(ImDrawIdx(inner + next));
+            pDraw->PrimWriteIdx(ImDrawIdx(inner + i));
+        }
+    };
+
+    auto fan = [&](ImDrawIdx ring) {
+        for (int i = 1; i < outlineCount - 1; i++)
+        {
+            pDraw->PrimWriteIdx(ring);
+            pDraw->PrimWriteIdx(ImDrawIdx(ring + i));
+            pDraw->PrimWriteIdx(ImDrawIdx(ring + i + 1));
+        }
+    };
+
+    auto transparent = [](const glm::vec4& color) {
+        return glm::vec4(color.x, color.y, color.z, 0.0f);
+    };
+
+    if (drawShadow)
+    {
+        auto shadowOuter = writeRing(topLeft + shadowOffset, bottomRight + shadowOffset, outerRadius, 0.5f, transparent(shadowColor));
+        auto shadowInner = writeRing(topLeft + shadowOffset, bottomRight + shadowOffset, outerRadius, -0.5f, shadowColor);
+        stitch(shadowOuter, shadowInner);
+        fan(shadowInner);
+    }
+
+    auto edgeColor = pixelBorder > 0.0f ? borderColor : centerColor;
+    auto bodyOuter = writeRing(topLeft, bottomRight, outerRadius, 0.5f, transparent(edgeColor));
+    auto bodyInner = writeRing(topLeft, bottomRight, outerRadius, -0.5f, edgeColor);
+    stitch(bodyOuter, bodyInner);
+
+    if (pixelBorder > 0.0f)
+    {
+        auto borderInner = writeRing(innerTopLeft, innerBottomRight, innerRadius, 0.5f, borderColor);
+        auto centerOuter = writeRing(innerTopLeft, innerBottomRight, innerRadius, -0.5f, centerColor);
+        stitch(bodyInner, borderInner);
+        stitch(borderInner, centerOuter);
+        fan(centerOuter);
+    }
+    else
+    {
+        fan(bodyInner);
+    }
+}
+
+void CanvasImGui::OnEndPath()
 {
     auto pDraw = ImGui::GetWindowDrawList();
     pDraw->PathFillConvex(m_pathColor);
 }
 
-void CanvasImGui::SetLineCap(LineCap cap)
+void CanvasImGui::OnSetLineCap(LineCap cap)
 {
     /*
     if (cap == LineCap::BUTT)
@@ -317,7 +602,7 @@ void CanvasImGui::SetLineCap(LineCap cap)
     */
 }
 
-void CanvasImGui::ClosePath()
+void CanvasImGui::OnClosePath()
 {
     m_closePath = true;
 }
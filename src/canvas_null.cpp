@@ -0,0 +1,188 @@
+#include <cstring>
+#include <numeric>
+
+#include <nodegraph/canvas_null.h>
+#include <nodegraph/fonts.h>
+
+namespace NodeGraph {
+
+namespace {
+
+const float TextWidthPerChar = 0.55f; // Of the font size; roughly a proportional sans face
+
+IFontTexture* null_font_texture()
+{
+    static FontTextureNull texture;
+    return &texture;
+}
+
+} // namespace
+
+uint64_t CanvasNullCounters::TotalCalls() const
+{
+    return std::accumulate(calls.begin(), calls.end(), uint64_t(0));
+}
+
+CanvasNull::CanvasNull(const glm::vec2& pixelSize, float worldScale, const glm::vec2& scaleLimits)
+    : Canvas(null_font_texture(), worldScale, scaleLimits)
+{
+    SetPixelRegionSize(pixelSize);
+}
+
+void CanvasNull::Begin(const glm::vec4& clearColor)
+{
+    BeginFrame();
+    m_counters.frames++;
+}
+
+void CanvasNull::End()
+{
+}
+
+NRectf CanvasNull::TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align) const
+{
+    m_counters.textMeasures++;
+    auto length = pszText ? strlen(pszText) : 0;
+    return NRectf(pos.x, pos.y, float(length) * size * TextWidthPerChar, size);
+}
+
+const CanvasNullCounters& CanvasNull::GetCounters() const
+{
+    return m_counters;
+}
+
+void CanvasNull::ResetCounters()
+{
+    m_counters = CanvasNullCounters();
+}
+
+void CanvasNull::Count(DrawCmdType type)
+{
+    m_counters.calls[size_t(type)]++;
+}
+
+void CanvasNull::OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
+{
+    Count(DrawCmdType::FilledCircle);
+}
+
+void CanvasNull::OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    Count(DrawCmdType::FilledGradientCircle);
+}
+
+void CanvasNull::OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
+{
+    Count(DrawCmdType::FillRoundedRect);
+}
+
+void CanvasNull::OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    Count(DrawCmdType::FillGradientRoundedRect);
+}
+
+void CanvasNull::OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    Count(DrawCmdType::FillGradientRoundedRectVarying);
+}
+
+void CanvasNull::OnFillRect(const NRectf& rc, const glm::vec4& color)
+{
+    Count(DrawCmdType::FillRect);
+}
+
+void CanvasNull::OnSetAA(bool set)
+{
+    Count(DrawCmdType::SetAA);
+}
+
+void CanvasNull::OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
+{
+    Count(DrawCmdType::BeginStroke);
+}
+
+void CanvasNull::OnBeginPath(const glm::vec2& from, const glm::vec4& color)
+{
+    Count(DrawCmdType::BeginPath);
+}
+
+void CanvasNull::OnMoveTo(const glm::vec2& to)
+{
+    Count(DrawCmdType::MoveTo);
+}
+
+void CanvasNull::OnLineTo(const glm::vec2& to)
+{
+    Count(DrawCmdType::LineTo);
+}
+
+void CanvasNull::OnClosePath()
+{
+    Count(DrawCmdType::ClosePath);
+}
+
+void CanvasNull::OnEndPath()
+{
+    Count(DrawCmdType::EndPath);
+}
+
+void CanvasNull::OnEndStroke()
+{
+    Count(DrawCmdType::EndStroke);
+}
+
+void CanvasNull::OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed)
+{
+    Count(DrawCmdType::Polyline);
+    m_counters.polylinePoints += points.size();
+}
+
+void CanvasNull::OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color)
+{
+    Count(DrawCmdType::FillConvexPolygon);
+    m_counters.polylinePoints += points.size();
+}
+
+void CanvasNull::OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs)
+{
+    m_counters.polylineBatches++;
+    m_counters.calls[size_t(DrawCmdType::Polyline)] += runs.size();
+    for (auto& run : runs)
+    {
+        m_counters.polylinePoints += run.count;
+    }
+}
+
+void CanvasNull::OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor)
+{
+    Count(DrawCmdType::Slab);
+}
+
+void CanvasNull::OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    Count(DrawCmdType::Text);
+    m_counters.textBytes += pszText ? strlen(pszText) : 0;
+}
+
+void CanvasNull::OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    Count(DrawCmdType::TextBox);
+    m_counters.textBytes += pszText ? strlen(pszText) : 0;
+}
+
+void CanvasNull::OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+{
+    Count(DrawCmdType::Stroke);
+}
+
+void CanvasNull::OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
+{
+    Count(DrawCmdType::Arc);
+}
+
+void CanvasNull::OnSetLineCap(LineCap cap)
+{
+    Count(DrawCmdType::SetLineCap);
+}
+
+} // namespace NodeGraph
@@ -0,0 +1,278 @@
+#include <istream>
+#include <ostream>
+
+#include <nodegraph/canvas_recorder.h>
+#include <nodegraph/fonts.h>
+
+namespace NodeGraph {
+
+namespace {
+
+const uint32_t TraceMagic = 0x5254474E; // 'NGTR'
+const uint32_t TraceVersion = 4;
+
+// The recorder never draws text itself; measuring is passed on to the target
+IFontTexture* recorder_font_texture()
+{
+    static FontTextureNull texture;
+    return &texture;
+}
+
+} // namespace
+
+void trace_write_header(std::ostream& out)
+{
+    uint32_t header[2] = { TraceMagic, TraceVersion };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+}
+
+bool trace_read_header(std::istream& in)
+{
+    uint32_t header[2] = { 0, 0 };
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)))
+    {
+        return false;
+    }
+    return header[0] == TraceMagic && header[1] == TraceVersion;
+}
+
+void trace_write_frame(std::ostream& out, const TraceFrame& frame)
+{
+    float view[9] = {
+        frame.pixelSize.x, frame.pixelSize.y,
+        frame.worldOrigin.x, frame.worldOrigin.y,
+        frame.worldScale,
+        frame.clearColor.x, frame.clearColor.y, frame.clearColor.z, frame.clearColor.w
+    };
+    out.write(reinterpret_cast<const char*>(view), sizeof(view));
+    frame.drawList.Write(out);
+}
+
+bool trace_read_frame(std::istream& in, TraceFrame& frame)
+{
+    float view[9];
+    if (!in.read(reinterpret_cast<char*>(view), sizeof(view)))
+    {
+        return false;
+    }
+
+    frame.pixelSize = glm::vec2(view[0], view[1]);
+    frame.worldOrigin = glm::vec2(view[2], view[3]);
+    frame.worldScale = view[4];
+    frame.clearColor = glm::vec4(view[5], view[6], view[7], view[8]);
+    return frame.drawList.Read(in);
+}
+
+void trace_replay_frame(Canvas& canvas, const TraceFrame& frame)
+{
+    canvas.SetPixelRegionSize(frame.pixelSize);
+    canvas.SetWorldView(frame.worldOrigin, frame.worldScale);
+    canvas.Begin(frame.clearColor);
+    frame.drawList.Replay(canvas);
+    canvas.End();
+}
+
+CanvasRecorder::CanvasRecorder(Canvas& target, std::ostream& trace)
+    : Canvas(recorder_font_texture(), target.GetWorldScale())
+    , m_target(target)
+    , m_trace(trace)
+{
+    SetPixelRegionSize(target.GetPixelRegionSize());
+    SetWorldView(target.GetWorldOrigin(), target.GetWorldScale());
+    trace_write_header(m_trace);
+}
+
+// The view is driven through the recorder, so the target is brought up to date each frame
+void CanvasRecorder::Begin(const glm::vec4& clearColor)
+{
+    BeginFrame();
+    m_target.SetPixelRegionSize(m_pixelSize);
+    m_target.SetWorldView(m_worldOrigin, m_worldScale);
+    m_target.Begin(clearColor);
+
+    m_frame.pixelSize = m_pixelSize;
+    m_frame.worldOrigin = m_worldOrigin;
+    m_frame.worldScale = m_worldScale;
+    m_frame.clearColor = clearColor;
+    m_frame.drawList.Clear();
+}
+
+void CanvasRecorder::End()
+{
+    m_target.End();
+
+    trace_write_frame(m_trace, m_frame);
+    m_frameCount++;
+}
+
+uint32_t CanvasRecorder::GetFrameCount() const
+{
+    return m_frameCount;
+}
+
+NRectf CanvasRecorder::TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align) const
+{
+    return m_target.TextBounds(pos, size, pszText, pszFace, align);
+}
+
+bool CanvasRecorder::HasGradientVarying() const
+{
+    return m_target.HasGradientVarying();
+}
+
+void CanvasRecorder::DrawCables(std::span<const CableDesc> cables)
+{
+    // Widgets capturing their draw caches through the recorder keep the description too
+    if (IsCapturing())
+    {
+        Canvas::DrawCables(cables);
+        return;
+    }
+
+    if (!cables.empty())
+    {
+        m_frame.drawList.Cables(cables);
+    }
+    m_target.DrawCables(cables);
+}
+
+void CanvasRecorder::OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
+{
+    m_frame.drawList.FilledCircle(center, radius, color);
+    m_target.FilledCircle(center, radius, color);
+}
+
+void CanvasRecorder::OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    m_frame.drawList.FilledGradientCircle(center, radius, gradientRange, startColor, endColor);
+    m_target.FilledGradientCircle(center, radius, gradientRange, startColor, endColor);
+}
+
+void CanvasRecorder::OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
+{
+    m_frame.drawList.FillRoundedRect(rc, radius, color);
+    m_target.FillRoundedRect(rc, radius, color);
+}
+
+void CanvasRecorder::OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    m_frame.drawList.FillGradientRoundedRect(rc, radius, gradientRange, startColor, endColor);
+    m_target.FillGradientRoundedRect(rc, radius, gradientRange, startColor, endColor);
+}
+
+void CanvasRecorder::OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    m_frame.drawList.FillGradientRoundedRectVarying(rc, radius, gradientRange, startColor, endColor);
+    m_target.FillGradientRoundedRectVarying(rc, radius, gradientRange, startColor, endColor);
+}
+
+void CanvasRecorder::OnFillRect(const NRectf& rc, const glm::vec4& color)
+{
+    m_frame.drawList.FillRect(rc, color);
+    m_target.FillRect(rc, color);
+}
+
+void CanvasRecorder::OnSetAA(bool set)
+{
+    m_frame.drawList.SetAA(set);
+    m_target.SetAA(set);
+}
+
+void CanvasRecorder::OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
+{
+    m_frame.drawList.BeginStroke(from, width, color);
+    m_target.BeginStroke(from, width, color);
+}
+
+void CanvasRecorder::OnBeginPath(const glm::vec2& from, const glm::vec4& color)
+{
+    m_frame.drawList.BeginPath(from, color);
+    m_target.BeginPath(from, color);
+}
+
+void CanvasRecorder::OnMoveTo(const glm::vec2& to)
+{
+    m_frame.drawList.MoveTo(to);
+    m_target.MoveTo(to);
+}
+
+void CanvasRecorder::OnLineTo(const glm::vec2& to)
+{
+    m_frame.drawList.LineTo(to);
+    m_target.LineTo(to);
+}
+
+void CanvasRecorder::OnClosePath()
+{
+    m_frame.drawList.ClosePath();
+    m_target.ClosePath();
+}
+
+void CanvasRecorder::OnEndPath()
+{
+    m_frame.drawList.EndPath();
+    m_target.EndPath();
+}
+
+void CanvasRecorder::OnEndStroke()
+{
+    m_frame.drawList.EndStroke();
+    m_target.EndStroke();
+}
+
+void CanvasRecorder::OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed)
+{
+    m_frame.drawList.Polyline(points, width, color, closed);
+    m_target.Polyline(points, width, color, closed);
+}
+
+void CanvasRecorder::OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color)
+{
+    m_frame.drawList.FillConvexPolygon(points, color);
+    m_target.FillConvexPolygon(points, color);
+}
+
+// Batches stay batches, both on the target and in the trace, so a replay measures the same backend path
+void CanvasRecorder::OnPolylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs)
+{
+    m_frame.drawList.Polylines(points, runs);
+    m_target.SubmitPolylines(points, runs);
+}
+
+void CanvasRecorder::OnSlab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor)
+{
+    m_frame.drawList.Slab(rc, radius, shadowSize, shadowColor, borderSize, borderColor, centerColor);
+    m_target.Slab(rc, radius, shadowSize, shadowColor, borderSize, borderColor, centerColor);
+}
+
+void CanvasRecorder::OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    m_frame.drawList.Text(pos, size, color, pszText, pszFace, align);
+    m_target.Text(pos, size, color, pszText, pszFace, align);
+}
+
+void CanvasRecorder::OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    m_frame.drawList.TextBox(pos, size, breakWidth, color, pszText, pszFace, align);
+    m_target.TextBox(pos, size, breakWidth, color, pszText, pszFace, align);
+}
+
+void CanvasRecorder::OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+{
+    m_frame.drawList.Stroke(from, to, width, color);
+    m_target.Stroke(from, to, width, color);
+}
+
+void CanvasRecorder::OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
+{
+    m_frame.drawList.Arc(pos, radius, width, color, startAngle, endAngle);
+    m_target.Arc(pos, radius, width, color, startAngle, endAngle);
+}
+
+void CanvasRecorder::OnSetLineCap(LineCap cap)
+{
+    m_frame.drawList.SetLineCap(cap);
+    m_target.SetLineCap(cap);
+}
+
+} // namespace NodeGraph
@@ -0,0 +1,628 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+#include <glm/gtc/packing.hpp>
+
+#include <zest/math/math_utils.h>
+
+#include <nodegraph/canvas_software.h>
+#include <nodegraph/fonts.h>
+#include <nodegraph/nodegraph.h>
+
+#include <config_nodegraph_app.h>
+
+namespace fs = std::filesystem;
+
+namespace NodeGraph {
+
+namespace {
+
+const float CurveTolerance = 0.2f; // Max distance of arc and corner polygons from the true curve, in pixels
+const int MaxArcSegments = 128;
+const float MinCoverage = 1.0f / 512.0f;
+
+IFontTexture* software_font_texture()
+{
+    static FontTextureNull texture;
+    return &texture;
+}
+
+glm::vec4 unpack_color(uint32_t val)
+{
+    return glm::vec4(float(val & 0xFF), float((val >> 8) & 0xFF), float((val >> 16) & 0xFF), float(val >> 24)) * (1.0f / 255.0f);
+}
+
+uint32_t pack_color(const glm::vec4& val)
+{
+    auto c = glm::clamp(val, glm::vec4(0.0f), glm::vec4(1.0f)) * 255.0f + 0.5f;
+    return uint32_t(c.x) | (uint32_t(c.y) << 8) | (uint32_t(c.z) << 16) | (uint32_t(c.w) << 24);
+}
+
+} // namespace
+
+CanvasSoftware::CanvasSoftware(const glm::uvec2& size, float worldScale, const glm::vec2& scaleLimits)
+    : Canvas(software_font_texture(), worldScale, scaleLimits)
+{
+    Resize(size);
+
+    auto fapath2 = fs::path(NODEGRAPH_ROOT) / "run_tree" / "fonts" / "fa-solid-900.ttf";
+    auto fontPath = fs::path(NODEGRAPH_ROOT) / "run_tree" / "fonts" / "Roboto-Regular.ttf";
+    m_defaultFont = fonts_create(*spFontContext, "sans", fontPath.string().c_str());
+    m_fontIcon = fonts_create(*spFontContext, "ficon", fapath2.string().c_str());
+
+    spFontContext->fnRenderText = [this](const FontVertex* pVerts, int nverts, uint32_t color) {
+        DrawGlyphs(pVerts, nverts, color);
+    };
+}
+
+void CanvasSoftware::Resize(const glm::uvec2& size)
+{
+    m_size = size;
+    m_pixels.resize(size_t(size.x) * size_t(size.y));
+    SetPixelRegionSize(glm::vec2(size));
+}
+
+glm::uvec2 CanvasSoftware::GetSize() const
+{
+    return m_size;
+}
+
+const std::vector<uint32_t>& CanvasSoftware::GetPixels() const
+{
+    return m_pixels;
+}
+
+void CanvasSoftware::Begin(const glm::vec4& clearColor)
+{
+    BeginFrame();
+    fonts_begin_frame(*spFontContext);
+    std::fill(m_pixels.begin(), m_pixels.end(), pack_color(clearColor));
+}
+
+void CanvasSoftware::End()
+{
+    fonts_end_frame(*spFontContext);
+}
+
+SoftwarePaint CanvasSoftware::SolidPaint(const glm::vec4& color) const
+{
+    SoftwarePaint paint;
+    paint.startColor = color;
+    paint.endColor = color;
+    return paint;
+}
+
+SoftwarePaint CanvasSoftware::GradientPaint(const NRectf& worldRange, const glm::vec4& startColor, const glm::vec4& endColor) const
+{
+    SoftwarePaint paint = SolidPaint(startColor);
+    paint.endColor = endColor;
+
+    // The gradient runs from the top left of the range to the bottom right
+    auto start = WorldToPixels(worldRange.topLeftPx);
+    auto delta = WorldToPixels(worldRange.bottomRightPx) - start;
+    auto lengthSq = glm::dot(delta, delta);
+    if (lengthSq > 0.0f)
+    {
+        paint.gradientStart = start;
+        paint.gradientStep = delta / lengthSq;
+        paint.gradient = true;
+    }
+    return paint;
+}
+
+void CanvasSoftware::AppendArc(std::vector<glm::vec2>& points, const glm::vec2& center, float radius, float startAngle, float endAngle) const
+{
+    if (radius <= 0.0f)
+    {
+        points.push_back(center);
+        return;
+    }
+
+    // Enough segments to keep the chords within tolerance of the circle
+    auto step = radius > CurveTolerance ? 2.0f * std::acos(1.0f - CurveTolerance / radius) : glm::pi<float>() * 0.5f;
+    auto segments = std::clamp(int(std::ceil(std::fabs(endAngle - startAngle) / step)), 1, MaxArcSegments);
+
+    for (int i = 0; i <= segments; i++)
+    {
+        auto angle = startAngle + (endAngle - startAngle) * (float(i) / float(segments));
+        points.push_back(center + glm::vec2(std::cos(angle), std::sin(angle)) * radius);
+    }
+}
+
+// Radius is per corner; top left, top right, bottom right, bottom left
+void CanvasSoftware::AppendRoundedRect(std::vector<glm::vec2>& points, const NRectf& worldRect, const glm::vec4& worldRadius) const
+{
+    auto a = WorldToPixels(worldRect.topLeftPx);
+    auto b = WorldToPixels(worldRect.bottomRightPx);
+    auto topLeft = glm::min(a, b);
+    auto bottomRight = glm::max(a, b);
+
+    auto maxRadius = std::min(bottomRight.x - topLeft.x, bottomRight.y - topLeft.y) * 0.5f;
+    auto radius = glm::clamp(worldRadius * m_worldScale, glm::vec4(0.0f), glm::vec4(maxRadius));
+
+    const auto pi = glm::pi<float>();
+    AppendArc(points, glm::vec2(topLeft.x + radius.x, topLeft.y + radius.x), radius.x, pi, pi * 1.5f);
+    AppendArc(points, glm::vec2(bottomRight.x - radius.y, topLeft.y + radius.y), radius.y, pi * 1.5f, pi * 2.0f);
+    AppendArc(points, glm::vec2(bottomRight.x - radius.z, bottomRight.y - radius.z), radius.z, 0.0f, pi * 0.5f);
+    AppendArc(points, glm::vec2(topLeft.x + radius.w, bottomRight.y - radius.w), radius.w, pi * 0.5f, pi);
+}
+
+// Closed polygon; every contour is wound the same way, so overlapping pieces union instead of cancelling
+void CanvasSoftware::AddContour(std::span<const glm::vec2> points)
+{
+    if (points.size() < 3)
+    {
+        return;
+    }
+
+    float area = 0.0f;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        auto& p0 = points[i];
+        auto& p1 = points[(i + 1) % points.size()];
+        area += p0.x * p1.y - p1.x * p0.y;
+    }
+
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        auto& p0 = points[i];
+        auto& p1 = points[(i + 1) % points.size()];
+        m_edges.push_back(area >= 0.0f ? p0 : p1);
+        m_edges.push_back(area >= 0.0f ? p1 : p0);
+    }
+}
+
+// A quad per segment, with round joins on anything thick enough to show a gap
+void CanvasSoftware::AddStroke(std::span<const glm::vec2> points, float halfWidth, bool closed)
+{
+    auto count = points.size();
+    if (count < 2)
+    {
+        return;
+    }
+
+    auto segments = closed ? count : count - 1;
+    for (size_t i = 0; i < segments; i++)
+    {
+        auto& p0 = points[i];
+        auto& p1 = points[(i + 1) % count];
+        auto delta = p1 - p0;
+        auto len = glm::length(delta);
+        if (len < 0.0001f)
+        {
+            continue;
+        }
+
+        auto normal = glm::vec2(-delta.y, delta.x) * (halfWidth / len);
+        glm::vec2 quad[4] = { p0 + normal, p1 + normal, p1 - normal, p0 - normal };
+        AddContour(quad);
+    }
+
+    if (halfWidth > 0.75f)
+    {
+        for (size_t i = closed ? 0 : 1; i < (closed ? count : count - 1); i++)
+        {
+            m_contour.clear();
+            AppendArc(m_contour, points[i], halfWidth, 0.0f, glm::pi<float>() * 2.0f);
+            AddContour(m_contour);
+        }
+    }
+}
+
+// Signed area accumulation; each edge adds the area it covers to the cells it crosses, so a running
+// sum along a row gives the exact coverage of each pixel.
+void CanvasSoftware::AccumulateEdge(const glm::vec2& from, const glm::vec2& to, int width, int height)
+{
+    if (from.y == to.y)
+    {
+        return;
+    }
+
+    auto p0 = from;
+    auto p1 = to;
+    float dir = 1.0f;
+    if (p0.y > p1.y)
+    {
+        std::swap(p0, p1);
+        dir = -1.0f;
+    }
+
+    if (p1.y <= 0.0f || p0.y >= float(height))
+    {
+        return;
+    }
+
+    auto dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+    auto yStart = std::max(0, int(std::floor(p0.y)));
+    auto yEnd = std::min(height, int(std::ceil(p1.y)));
+    auto x = p0.x + (std::max(p0.y, float(yStart)) - p0.y) * dxdy;
+
+    const int stride = width + 2;
+    for (int y = yStart; y < yEnd; y++)
+    {
+        auto dy = std::min(float(y + 1), p1.y) - std::max(float(y), p0.y);
+        auto xNext = x + dxdy * dy;
+        auto d = dy * dir;
+
+        // Anything left of the bounds still covers the first column; anything right of them is never read
+        auto x0 = std::clamp(std::min(x, xNext), 0.0f, float(width));
+        auto x1 = std::clamp(std::max(x, xNext), 0.0f, float(width));
+
+        auto pRow = &m_coverage[size_t(y) * stride];
+        auto x0Floor = std::floor(x0);
+        auto x0i = int(x0Floor);
+        auto x1Ceil = std::ceil(x1);
+        auto x1i = int(x1Ceil);
+        if (x1i <= x0i + 1)
+        {
+            // Inside a single pixel
+            auto xmf = 0.5f * (x0 + x1) - x0Floor;
+            pRow[x0i] += d - d * xmf;
+            pRow[x0i + 1] += d * xmf;
+        }
+        else
+        {
+            auto s = 1.0f / (x1 - x0);
+            auto x0f = x0 - x0Floor;
+            auto a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+            auto x1f = x1 - x1Ceil + 1.0f;
+            auto am = 0.5f * s * x1f * x1f;
+            pRow[x0i] += d * a0;
+            if (x1i == x0i + 2)
+            {
+                pRow[x0i + 1] += d * (1.0f - a0 - am);
+            }
+            else
+            {
+                auto a1 = s * (1.5f - x0f);
+                pRow[x0i + 1] += d * (a1 - a0);
+                for (int xi = x0i + 2; xi < x1i - 1; xi++)
+                {
+                    pRow[xi] += d * s;
+                }
+                auto a2 = a1 + float(x1i - x0i - 3) * s;
+                pRow[x1i - 1] += d * (1.0f - a2 - am);
+            }
+            pRow[x1i] += d * am;
+        }
+        x = xNext;
+    }
+}
+
+void CanvasSoftware::FillEdges(const SoftwarePaint& paint)
+{
+    if (m_edges.empty() || m_pixels.empty())
+    {
+        m_edges.clear();
+        return;
+    }
+
+    auto minPos = m_edges[0];
+    auto maxPos = m_edges[0];
+    for (auto& pt : m_edges)
+    {
+        minPos = glm::min(minPos, pt);
+        maxPos = glm::max(maxPos, pt);
+    }
+
+    // Only the part of the polygon that lands on the buffer is rasterized
+    auto left = std::max(0, int(std::floor(minPos.x)));
+    auto top = std::max(0, int(std::floor(minPos.y)));
+    auto right = std::min(int(m_size.x), int(std::ceil(maxPos.x)));
+    auto bottom = std::min(int(m_size.y), int(std::ceil(maxPos.y)));
+    auto width = right - left;
+    auto height = bottom - top;
+    if (width <= 0 || height <= 0)
+    {
+        m_edges.clear();
+        return;
+    }
+
+    m_coverage.assign(size_t(width + 2) * height, 0.0f);
+    auto offset = glm::vec2(float(left), float(top));
+    for (size_t i = 0; i < m_edges.size(); i += 2)
+    {
+        AccumulateEdge(m_edges[i] - offset, m_edges[i + 1] - offset, width, height);
+    }
+    m_edges.clear();
+
+    m_spanCoverage.resize(width);
+    for (int y = 0; y < height; y++)
+    {
+        auto pRow = &m_coverage[size_t(y) * (width + 2)];
+        float acc = 0.0f;
+        for (int x = 0; x < width; x++)
+        {
+            acc += pRow[x];
+            m_spanCoverage[x] = std::min(std::fabs(acc), 1.0f);
+        }
+
+        auto pDest = &m_pixels[size_t(top + y) * m_size.x + left];
+        BlendSpan(pDest, m_spanCoverage.data(), width, paint, glm::vec2(float(left), float(top + y)) + 0.5f);
+    }
+}
+
+// Source over blend of a run of pixels. The solid color path has no per pixel branches or paint
+// evaluation, so the compiler can vectorize it.
+void CanvasSoftware::BlendSpan(uint32_t* pDest, const float* pCoverage, int count, const SoftwarePaint& paint, const glm::vec2& pixelStart)
+{
+    if (!paint.gradient)
+    {
+        auto src = paint.startColor;
+        for (int i = 0; i < count; i++)
+        {
+            auto alpha = src.w * pCoverage[i];
+            auto dst = unpack_color(pDest[i]);
+            auto out = glm::vec4(glm::vec3(src.x, src.y, src.z) * alpha + glm::vec3(dst.x, dst.y, dst.z) * (1.0f - alpha), alpha + dst.w * (1.0f - alpha));
+            pDest[i] = pack_color(out);
+        }
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (pCoverage[i] < MinCoverage)
+        {
+            continue;
+        }
+
+        auto pos = pixelStart + glm::vec2(float(i), 0.0f);
+        auto t = std::clamp(glm::dot(pos - paint.gradientStart, paint.gradientStep), 0.0f, 1.0f);
+        auto src = glm::mix(paint.startColor, paint.endColor, t);
+
+        auto alpha = src.w * pCoverage[i];
+        auto dst = unpack_color(pDest[i]);
+        auto out = glm::vec4(glm::vec3(src.x, src.y, src.z) * alpha + glm::vec3(dst.x, dst.y, dst.z) * (1.0f - alpha), alpha + dst.w * (1.0f - alpha));
+        pDest[i] = pack_color(out);
+    }
+}
+
+// Glyph quads arrive in pixels; each one is sampled bilinearly from the alpha atlas
+void CanvasSoftware::DrawGlyphs(const FontVertex* pVerts, int nverts, uint32_t color)
+{
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+    auto pAtlas = fonsGetTextureData(spFontContext->fs, &atlasWidth, &atlasHeight);
+    if (!pAtlas || atlasWidth == 0 || atlasHeight == 0)
+    {
+        return;
+    }
+
+    auto atlasAt = [&](int x, int y) {
+        x = std::clamp(x, 0, atlasWidth - 1);
+        y = std::clamp(y, 0, atlasHeight - 1);
+        return float(pAtlas[y * atlasWidth + x]) * (1.0f / 255.0f);
+    };
+
+    auto paint = SolidPaint(unpack_color(color));
+    for (int i = 0; i + 1 < nverts; i += 2)
+    {
+        auto& v0 = pVerts[i];
+        auto& v1 = pVerts[i + 1];
+        if (v1.x <= v0.x || v1.y <= v0.y)
+        {
+            continue;
+        }
+
+        auto left = std::max(0, int(std::floor(v0.x)));
+        auto top = std::max(0, int(std::floor(v0.y)));
+        auto right = std::min(int(m_size.x), int(std::ceil(v1.x)));
+        auto bottom = std::min(int(m_size.y), int(std::ceil(v1.y)));
+        if (right <= left || bottom <= top)
+        {
+            continue;
+        }
+
+        m_spanCoverage.resize(right - left);
+        for (int y = top; y < bottom; y++)
+        {
+            auto fy = (float(y) + 0.5f - v0.y) / (v1.y - v0.y);
+            auto texY = (v0.v + (v1.v - v0.v) * fy) * atlasHeight - 0.5f;
+            auto ty = int(std::floor(texY));
+            auto wy = texY - float(ty);
+
+            for (int x = left; x < right; x++)
+            {
+                auto fx = (float(x) + 0.5f - v0.x) / (v1.x - v0.x);
+                auto texX = (v0.u + (v1.u - v0.u) * fx) * atlasWidth - 0.5f;
+                auto tx = int(std::floor(texX));
+                auto wx = texX - float(tx);
+
+                auto topRow = atlasAt(tx, ty) * (1.0f - wx) + atlasAt(tx + 1, ty) * wx;
+                auto bottomRow = atlasAt(tx, ty + 1) * (1.0f - wx) + atlasAt(tx + 1, ty + 1) * wx;
+                m_spanCoverage[x - left] = topRow * (1.0f - wy) + bottomRow * wy;
+            }
+
+            BlendSpan(&m_pixels[size_t(y) * m_size.x + left], m_spanCoverage.data(), right - left, paint, glm::vec2(float(left), float(y)) + 0.5f);
+        }
+    }
+}
+
+void CanvasSoftware::SetupFont(const char* pszFace, float size, uint32_t align) const
+{
+    if (pszFace != nullptr)
+    {
+        fonts_set_face(*spFontContext, pszFace);
+    }
+    else
+    {
+        fonts_set_face(*spFontContext, m_defaultFont);
+    }
+
+    fonts_set_size(*spFontContext, size);
+    fonts_set_align(*spFontContext, align);
+    fonts_set_scale(*spFontContext, m_worldScale);
+}
+
+NRectf CanvasSoftware::TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align) const
+{
+    auto pixelPos = WorldToPixels(pos);
+
+    SetupFont(pszFace, size, align);
+    auto width = fonts_text_bounds(*spFontContext, pixelPos.x / m_worldScale, pixelPos.y / m_worldScale, pszText, nullptr, nullptr);
+
+    // Return everything in World space, since we scale every draw call
+    return NRectf(pos.x, pos.y, PixelSizeToWorldSize(width) * m_worldScale, PixelSizeToWorldSize(size));
+}
+
+void CanvasSoftware::OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    auto pixelPos = WorldToPixels(pos);
+
+    SetupFont(pszFace, size, align);
+    fonts_draw_text(*spFontContext, pixelPos.x / m_worldScale, pixelPos.y / m_worldScale, glm::packUnorm4x8(color), pszText, nullptr);
+}
+
+void CanvasSoftware::OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    auto pixelPos = WorldToPixels(pos);
+
+    SetupFont(pszFace, size, align);
+    fonts_text_box(*spFontContext, pixelPos.x / m_worldScale, pixelPos.y / m_worldScale, breakWidth, glm::packUnorm4x8(color), pszText, nullptr);
+}
+
+void CanvasSoftware::OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
+{
+    m_contour.clear();
+    AppendArc(m_contour, WorldToPixels(center), WorldSizeToPixelSize(radius), 0.0f, glm::pi<float>() * 2.0f);
+    AddContour(m_contour);
+    FillEdges(SolidPaint(color));
+}
+
+void CanvasSoftware::OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    m_contour.clear();
+    AppendArc(m_contour, WorldToPixels(center), WorldSizeToPixelSize(radius), 0.0f, glm::pi<float>() * 2.0f);
+    AddContour(m_contour);
+    FillEdges(GradientPaint(gradientRange, startColor, endColor));
+}
+
+void CanvasSoftware::OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
+{
+    m_contour.clear();
+    AppendRoundedRect(m_contour, rc, glm::vec4(radius));
+    AddContour(m_contour);
+    FillEdges(SolidPaint(color));
+}
+
+void CanvasSoftware::OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    m_contour.clear();
+    AppendRoundedRect(m_contour, rc, glm::vec4(radius));
+    AddContour(m_contour);
+    FillEdges(GradientPaint(gradientRange, startColor, endColor));
+}
+
+void CanvasSoftware::OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    m_contour.clear();
+    AppendRoundedRect(m_contour, rc, radius);
+    AddContour(m_contour);
+    FillEdges(GradientPaint(gradientRange, startColor, endColor));
+}
+
+void CanvasSoftware::OnFillRect(const NRectf& rc, const glm::vec4& color)
+{
+    m_contour.clear();
+    AppendRoundedRect(m_contour, rc, glm::vec4(0.0f));
+    AddContour(m_contour);
+    FillEdges(SolidPaint(color));
+}
+
+void CanvasSoftware::OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+{
+    glm::vec2 points[2] = { WorldToPixels(from), WorldToPixels(to) };
+    AddStroke(points, WorldSizeToPixelSize(width) * 0.5f, false);
+    FillEdges(SolidPaint(color));
+}
+
+void CanvasSoftware::OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
+{
+    auto center = WorldToPixels(pos);
+    auto pixelRadius = WorldSizeToPixelSize(radius);
+    auto halfWidth = WorldSizeToPixelSize(width) * 0.5f;
+    auto start = Zest::degToRad(startAngle);
+    auto end = Zest::degToRad(endAngle);
+
+    // A ring section; out along the outer edge and back along the inner one
+    m_contour.clear();
+    AppendArc(m_contour, center, pixelRadius + halfWidth, start, end);
+    AppendArc(m_contour, center, std::max(0.0f, pixelRadius - halfWidth), end, start);
+    AddContour(m_contour);
+    FillEdges(SolidPaint(color));
+}
+
+void CanvasSoftware::OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed)
+{
+    m_path.resize(points.size());
+    WorldPointsToPixels(points, m_path.data());
+    AddStroke(m_path, WorldSizeToPixelSize(width) * 0.5f, closed);
+    FillEdges(SolidPaint(color));
+}
+
+void CanvasSoftware::OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color)
+{
+    m_path.resize(points.size());
+    WorldPointsToPixels(points, m_path.data());
+    AddContour(m_path);
+    FillEdges(SolidPaint(color));
+}
+
+void CanvasSoftware::OnSetAA(bool set)
+{
+    /* Always anti-aliased */
+    M_UNUSED(set);
+}
+
+void CanvasSoftware::OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
+{
+    m_path.clear();
+    m_path.push_back(WorldToPixels(from));
+    m_pathWidth = WorldSizeToPixelSize(width);
+    m_pathColor = color;
+    m_closePath = false;
+}
+
+void CanvasSoftware::OnBeginPath(const glm::vec2& from, const glm::vec4& color)
+{
+    m_path.clear();
+    m_path.push_back(WorldToPixels(from));
+    m_pathColor = color;
+    m_closePath = false;
+}
+
+void CanvasSoftware::OnMoveTo(const glm::vec2& to)
+{
+    m_path.clear();
+    m_path.push_back(WorldToPixels(to));
+}
+
+void CanvasSoftware::OnLineTo(const glm::vec2& to)
+{
+    m_path.push_back(WorldToPixels(to));
+}
+
+void CanvasSoftware::OnClosePath()
+{
+    m_closePath = true;
+}
+
+void CanvasSoftware::OnEndPath()
+{
+    AddContour(m_path);
+    FillEdges(SolidPaint(m_pathColor));
+}
+
+void CanvasSoftware::OnEndStroke()
+{
+    AddStroke(m_path, m_pathWidth * 0.5f, m_closePath);
+    FillEdges(SolidPaint(m_pathColor));
+}
+
+void CanvasSoftware::OnSetLineCap(LineCap cap)
+{
+    /* Butt caps with round joins */
+}
+
+} // namespace NodeGraph
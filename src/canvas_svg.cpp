@@ -0,0 +1,722 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+
+#include <glm/gtc/packing.hpp>
+
+#include <zest/math/math_utils.h>
+
+#include <nodegraph/canvas_svg.h>
+#include <nodegraph/fonts.h>
+#include <nodegraph/nodegraph.h>
+
+#include <config_nodegraph_app.h>
+
+namespace fs = std::filesystem;
+
+namespace NodeGraph {
+
+namespace {
+
+const size_t MaxBatchBytes = 64 * 1024; // Long batches are split, so no single path string grows without limit
+const size_t MaxDefs = 1024; // Past this the definition cache starts again; repeats are just written out again
+
+IFontTexture* svg_font_texture()
+{
+    static FontTextureNull texture;
+    return &texture;
+}
+
+// Two decimal places is plenty for pixels, and keeps large documents small
+void append_number(std::string& out, float val)
+{
+    val = std::round(val * 100.0f) / 100.0f;
+    if (val == 0.0f)
+    {
+        out += '0';
+        return;
+    }
+
+    char buffer[32];
+    auto res = std::to_chars(buffer, buffer + sizeof(buffer), val, std::chars_format::fixed, 2);
+    auto pEnd = res.ptr;
+    while (*(pEnd - 1) == '0')
+    {
+        pEnd--;
+    }
+    if (*(pEnd - 1) == '.')
+    {
+        pEnd--;
+    }
+    out.append(buffer, pEnd);
+}
+
+void append_point(std::string& out, char command, const glm::vec2& pt)
+{
+    out += command;
+    append_number(out, pt.x);
+    out += ' ';
+    append_number(out, pt.y);
+}
+
+// A clockwise circular arc from the current point
+void append_arc(std::string& out, float radius, const glm::vec2& to, bool largeArc = false, bool sweep = true)
+{
+    out += 'A';
+    append_number(out, radius);
+    out += ' ';
+    append_number(out, radius);
+    out += largeArc ? " 0 1 " : " 0 0 ";
+    out += sweep ? "1 " : "0 ";
+    append_number(out, to.x);
+    out += ' ';
+    append_number(out, to.y);
+}
+
+void append_color(std::string& out, const char* pszAttr, const char* pszOpacityAttr, const glm::vec4& color)
+{
+    static const char* Hex = "0123456789abcdef";
+    auto rgb = glm::clamp(color, glm::vec4(0.0f), glm::vec4(1.0f)) * 255.0f + 0.5f;
+
+    out += ' ';
+    out += pszAttr;
+    out += "=\"#";
+    for (auto component : { rgb.x, rgb.y, rgb.z })
+    {
+        auto val = int(component);
+        out += Hex[val >> 4];
+        out += Hex[val & 0xF];
+    }
+    out += '"';
+
+    if (color.w < 1.0f)
+    {
+        out += ' ';
+        out += pszOpacityAttr;
+        out += "=\"";
+        append_number(out, std::max(color.w, 0.0f));
+        out += '"';
+    }
+}
+
+void append_escaped(std::string& out, const char* pszText, const char* pszEnd)
+{
+    for (auto pCh = pszText; pCh != pszEnd && *pCh != 0; pCh++)
+    {
+        switch (*pCh)
+        {
+        case '&':
+            out += "&amp;";
+            break;
+        case '<':
+            out += "&lt;";
+            break;
+        case '>':
+            out += "&gt;";
+            break;
+        case '"':
+            out += "&quot;";
+            break;
+        default:
+            out += *pCh;
+            break;
+        }
+    }
+}
+
+} // namespace
+
+CanvasSVG::CanvasSVG(std::ostream& out, const glm::uvec2& size, float worldScale, const glm::vec2& scaleLimits)
+    : Canvas(svg_font_texture(), worldScale, scaleLimits)
+    , m_out(out)
+{
+    Resize(size);
+
+    // Fonts are only loaded for their metrics; the text itself is written out as <text>
+    auto fapath2 = fs::path(NODEGRAPH_ROOT) / "run_tree" / "fonts" / "fa-solid-900.ttf";
+    auto fontPath = fs::path(NODEGRAPH_ROOT) / "run_tree" / "fonts" / "Roboto-Regular.ttf";
+    m_defaultFont = fonts_create(*spFontContext, "sans", fontPath.string().c_str());
+    m_fontIcon = fonts_create(*spFontContext, "ficon", fapath2.string().c_str());
+}
+
+void CanvasSVG::Resize(const glm::uvec2& size)
+{
+    m_size = size;
+    SetPixelRegionSize(glm::vec2(size));
+}
+
+glm::uvec2 CanvasSVG::GetSize() const
+{
+    return m_size;
+}
+
+void CanvasSVG::Begin(const glm::vec4& clearColor)
+{
+    BeginFrame();
+    fonts_begin_frame(*spFontContext);
+
+    // Definitions don't carry between documents
+    m_defs.clear();
+    m_batchType = BatchType::None;
+    m_batch.clear();
+
+    m_line = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"";
+    m_line += std::to_string(m_size.x);
+    m_line += "\" height=\"";
+    m_line += std::to_string(m_size.y);
+    m_line += "\" viewBox=\"0 0 ";
+    m_line += std::to_string(m_size.x);
+    m_line += ' ';
+    m_line += std::to_string(m_size.y);
+    m_line += "\">\n<rect width=\"100%\" height=\"100%\"";
+    append_color(m_line, "fill", "fill-opacity", clearColor);
+    m_line += "/>\n";
+    m_out << m_line;
+}
+
+void CanvasSVG::End()
+{
+    FlushBatch();
+    m_out << "</svg>\n";
+    m_out.flush();
+
+    fonts_end_frame(*spFontContext);
+}
+
+// Only opaque styles are merged; overlapping translucent shapes must still blend over each other
+std::string& CanvasSVG::BeginBatch(BatchType type, const glm::vec4& color, float width)
+{
+    if (m_batchType != type || m_batchColor != color || m_batchWidth != width || color.w < 1.0f || m_batch.size() > MaxBatchBytes)
+    {
+        FlushBatch();
+        m_batchType = type;
+        m_batchColor = color;
+        m_batchWidth = width;
+    }
+    return m_batch;
+}
+
+void CanvasSVG::FlushBatch()
+{
+    if (m_batchType == BatchType::None || m_batch.empty())
+    {
+        m_batchType = BatchType::None;
+        m_batch.clear();
+        return;
+    }
+
+    m_line = "<path d=\"";
+    m_line += m_batch;
+    m_line += '"';
+    if (m_batchType == BatchType::Fill)
+    {
+        append_color(m_line, "fill", "fill-opacity", m_batchColor);
+    }
+    else
+    {
+        m_line += " fill=\"none\"";
+        append_color(m_line, "stroke", "stroke-opacity", m_batchColor);
+        m_line += " stroke-width=\"";
+        append_number(m_line, m_batchWidth);
+        m_line += m_lineCap == LineCap::ROUND ? "\" stroke-linecap=\"round\"" : "\" stroke-linecap=\"butt\"";
+        m_line += " stroke-linejoin=\"round\"";
+    }
+
+    if (!m_antiAlias)
+    {
+        m_line += " shape-rendering=\"crispEdges\"";
+    }
+    m_line += "/>\n";
+    m_out << m_line;
+
+    m_batchType = BatchType::None;
+    m_batch.clear();
+}
+
+// Clockwise, like the circles, so merged shapes union under the nonzero fill rule.
+// Radius is per corner; top left, top right, bottom right, bottom left
+void CanvasSVG::AppendRoundedRect(std::string& d, const NRectf& worldRect, const glm::vec4& worldRadius) const
+{
+    auto a = WorldToPixels(worldRect.topLeftPx);
+    auto b = WorldToPixels(worldRect.bottomRightPx);
+    auto topLeft = glm::min(a, b);
+    auto bottomRight = glm::max(a, b);
+
+    auto maxRadius = std::min(bottomRight.x - topLeft.x, bottomRight.y - topLeft.y) * 0.5f;
+    auto radius = glm::clamp(worldRadius * m_worldScale, glm::vec4(0.0f), glm::vec4(maxRadius));
+
+    append_point(d, 'M', glm::vec2(topLeft.x + radius.x, topLeft.y));
+    d += 'H';
+    append_number(d, bottomRight.x - radius.y);
+    if (radius.y > 0.0f)
+    {
+        append_arc(d, radius.y, glm::vec2(bottomRight.x, topLeft.y + radius.y));
+    }
+    d += 'V';
+    append_number(d, bottomRight.y - radius.z);
+    if (radius.z > 0.0f)
+    {
+        append_arc(d, radius.z, glm::vec2(bottomRight.x - radius.z, bottomRight.y));
+    }
+    d += 'H';
+    append_number(d, topLeft.x + radius.w);
+    if (radius.w > 0.0f)
+    {
+        append_arc(d, radius.w, glm::vec2(topLeft.x, bottomRight.y - radius.w));
+    }
+    d += 'V';
+    append_number(d, topLeft.y + radius.x);
+    if (radius.x > 0.0f)
+    {
+        append_arc(d, radius.x, glm::vec2(topLeft.x + radius.x, topLeft.y));
+    }
+    d += 'Z';
+}
+
+void CanvasSVG::AppendCircle(std::string& d, const glm::vec2& worldCenter, float worldRadius) const
+{
+    auto center = WorldToPixels(worldCenter);
+    auto radius = WorldSizeToPixelSize(worldRadius);
+    append_point(d, 'M', glm::vec2(center.x + radius, center.y));
+    append_arc(d, radius, glm::vec2(center.x - radius, center.y), true);
+    append_arc(d, radius, glm::vec2(center.x + radius, center.y), true);
+    d += 'Z';
+}
+
+// The gradient vector is stored relative to the shape's bounds, so every knob or node with the same
+// look shares one definition
+void CanvasSVG::WriteGradientShape(const std::string& d, const NRectf& worldBounds, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    FlushBatch();
+
+    auto a = WorldToPixels(worldBounds.topLeftPx);
+    auto b = WorldToPixels(worldBounds.bottomRightPx);
+    auto topLeft = glm::min(a, b);
+    auto size = glm::max(glm::max(a, b) - topLeft, glm::vec2(0.0001f));
+
+    auto gradientStart = (WorldToPixels(gradientRange.topLeftPx) - topLeft) / size;
+    auto gradientEnd = (WorldToPixels(gradientRange.bottomRightPx) - topLeft) / size;
+    auto id = GradientDef(glm::vec4(gradientStart, gradientEnd), startColor, endColor);
+
+    m_line = "<path d=\"";
+    m_line += d;
+    m_line += "\" fill=\"url(#d";
+    m_line += std::to_string(id);
+    m_line += ")\"";
+    if (!m_antiAlias)
+    {
+        m_line += " shape-rendering=\"crispEdges\"";
+    }
+    m_line += "/>\n";
+    m_out << m_line;
+}
+
+uint32_t CanvasSVG::GradientDef(const glm::vec4& vector, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    std::string key = "g";
+    for (int i = 0; i < 4; i++)
+    {
+        append_number(key, vector[i]);
+        key += ' ';
+    }
+    key += std::to_string(glm::packUnorm4x8(startColor));
+    key += ' ';
+    key += std::to_string(glm::packUnorm4x8(endColor));
+
+    auto itr = m_defs.find(key);
+    if (itr != m_defs.end())
+    {
+        return itr->second;
+    }
+
+    if (m_defs.size() >= MaxDefs)
+    {
+        m_defs.clear();
+    }
+    auto id = m_nextDefId++;
+    m_defs[key] = id;
+
+    m_line = "<defs><linearGradient id=\"d";
+    m_line += std::to_string(id);
+    const char* coords[4] = { "\" x1=\"", "\" y1=\"", "\" x2=\"", "\" y2=\"" };
+    for (int i = 0; i < 4; i++)
+    {
+        m_line += coords[i];
+        append_number(m_line, vector[i]);
+    }
+    m_line += "\"><stop offset=\"0\"";
+    append_color(m_line, "stop-color", "stop-opacity", startColor);
+    m_line += "/><stop offset=\"1\"";
+    append_color(m_line, "stop-color", "stop-opacity", endColor);
+    m_line += "/></linearGradient></defs>\n";
+    m_out << m_line;
+    return id;
+}
+
+uint32_t CanvasSVG::FontDef(const char* pszFace, float pixelSize, uint32_t align)
+{
+    std::string key = "f";
+    key += pszFace ? pszFace : "sans";
+    key += ' ';
+    append_number(key, pixelSize);
+    key += ' ';
+    key += std::to_string(align);
+
+    auto itr = m_defs.find(key);
+    if (itr != m_defs.end())
+    {
+        return itr->second;
+    }
+
+    if (m_defs.size() >= MaxDefs)
+    {
+        m_defs.clear();
+    }
+    auto id = m_nextDefId++;
+    m_defs[key] = id;
+
+    m_line = "<defs><style>.d";
+    m_line += std::to_string(id);
+    if (pszFace == nullptr || std::string(pszFace) == "sans")
+    {
+        m_line += "{font-family:Roboto,sans-serif";
+    }
+    else if (std::string(pszFace) == "ficon")
+    {
+        m_line += "{font-family:'Font Awesome 6 Free','Font Awesome 5 Free';font-weight:900";
+    }
+    else
+    {
+        m_line += "{font-family:'";
+        m_line += pszFace;
+        m_line += "'";
+    }
+
+    m_line += ";font-size:";
+    append_number(m_line, pixelSize);
+    m_line += "px";
+
+    if (align & TEXT_ALIGN_CENTER)
+    {
+        m_line += ";text-anchor:middle";
+    }
+    else if (align & TEXT_ALIGN_RIGHT)
+    {
+        m_line += ";text-anchor:end";
+    }
+
+    if (align & TEXT_ALIGN_TOP)
+    {
+        m_line += ";dominant-baseline:text-before-edge";
+    }
+    else if (align & TEXT_ALIGN_MIDDLE)
+    {
+        m_line += ";dominant-baseline:central";
+    }
+    else if (align & TEXT_ALIGN_BOTTOM)
+    {
+        m_line += ";dominant-baseline:text-after-edge";
+    }
+    m_line += "}</style></defs>\n";
+    m_out << m_line;
+    return id;
+}
+
+void CanvasSVG::WriteText(const glm::vec2& pixelPos, const char* pszText, const char* pszEnd, uint32_t fontDef, const glm::vec4& color)
+{
+    FlushBatch();
+
+    m_line = "<text x=\"";
+    append_number(m_line, pixelPos.x);
+    m_line += "\" y=\"";
+    append_number(m_line, pixelPos.y);
+    m_line += "\" class=\"d";
+    m_line += std::to_string(fontDef);
+    m_line += '"';
+    append_color(m_line, "fill", "fill-opacity", color);
+    m_line += '>';
+    append_escaped(m_line, pszText, pszEnd);
+    m_line += "</text>\n";
+    m_out << m_line;
+}
+
+void CanvasSVG::SetupFont(const char* pszFace, float size, uint32_t align) const
+{
+    if (pszFace != nullptr)
+    {
+        fonts_set_face(*spFontContext, pszFace);
+    }
+    else
+    {
+        fonts_set_face(*spFontContext, m_defaultFont);
+    }
+
+    fonts_set_size(*spFontContext, size);
+    fonts_set_align(*spFontContext, align);
+    fonts_set_scale(*spFontContext, m_worldScale);
+}
+
+NRectf CanvasSVG::TextBounds(const glm::vec2& pos, float size, const char* pszText, const char* pszFace, uint32_t align) const
+{
+    auto pixelPos = WorldToPixels(pos);
+
+    SetupFont(pszFace, size, align);
+    auto width = fonts_text_bounds(*spFontContext, pixelPos.x / m_worldScale, pixelPos.y / m_worldScale, pszText, nullptr, nullptr);
+
+    // Return everything in World space, since we scale every draw call
+    return NRectf(pos.x, pos.y, PixelSizeToWorldSize(width) * m_worldScale, PixelSizeToWorldSize(size));
+}
+
+void CanvasSVG::OnText(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    if (pszText == nullptr)
+    {
+        return;
+    }
+    WriteText(WorldToPixels(pos), pszText, nullptr, FontDef(pszFace, WorldSizeToPixelSize(size), align), color);
+}
+
+// Rows are broken with the same metrics as the other backends, and written as a <text> each
+void CanvasSVG::OnTextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    if (pszText == nullptr)
+    {
+        return;
+    }
+
+    auto& ctx = *spFontContext;
+    SetupFont(pszFace, size, align);
+    if (ctx.fontId == FONS_INVALID)
+    {
+        return;
+    }
+
+    float lineh = 0.0f;
+    fonts_text_metrics(ctx, nullptr, nullptr, &lineh);
+
+    auto halign = align & (TEXT_ALIGN_LEFT | TEXT_ALIGN_CENTER | TEXT_ALIGN_RIGHT);
+    auto valign = align & (TEXT_ALIGN_TOP | TEXT_ALIGN_MIDDLE | TEXT_ALIGN_BOTTOM | TEXT_ALIGN_BASELINE);
+    auto fontDef = FontDef(pszFace, WorldSizeToPixelSize(size), TEXT_ALIGN_LEFT | valign);
+
+    // Font space is pixels over the world scale
+    auto pixelPos = WorldToPixels(pos);
+    auto x = pixelPos.x / m_worldScale;
+    auto y = pixelPos.y / m_worldScale;
+
+    NVGtextRow rows[2];
+    int rowCount = 0;
+    while ((rowCount = fonts_break_lines(ctx, pszText, nullptr, breakWidth, rows, 2)))
+    {
+        for (int i = 0; i < rowCount; i++)
+        {
+            auto& row = rows[i];
+            auto rowX = x;
+            if (halign & TEXT_ALIGN_CENTER)
+            {
+                rowX += breakWidth * 0.5f - row.width * 0.5f;
+            }
+            else if (halign & TEXT_ALIGN_RIGHT)
+            {
+                rowX += breakWidth - row.width;
+            }
+            WriteText(glm::vec2(rowX, y) * m_worldScale, row.start, row.end, fontDef, color);
+            y += lineh * ctx.lineHeight;
+        }
+        pszText = rows[rowCount - 1].next;
+    }
+}
+
+void CanvasSVG::OnFilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
+{
+    AppendCircle(BeginBatch(BatchType::Fill, color), center, radius);
+}
+
+void CanvasSVG::OnFilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    std::string d;
+    AppendCircle(d, center, radius);
+    WriteGradientShape(d, NRectf(center.x - radius, center.y - radius, radius * 2.0f, radius * 2.0f), gradientRange, startColor, endColor);
+}
+
+void CanvasSVG::OnFillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
+{
+    AppendRoundedRect(BeginBatch(BatchType::Fill, color), rc, glm::vec4(radius));
+}
+
+void CanvasSVG::OnFillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    std::string d;
+    AppendRoundedRect(d, rc, glm::vec4(radius));
+    WriteGradientShape(d, rc, gradientRange, startColor, endColor);
+}
+
+void CanvasSVG::OnFillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    std::string d;
+    AppendRoundedRect(d, rc, radius);
+    WriteGradientShape(d, rc, gradientRange, startColor, endColor);
+}
+
+void CanvasSVG::OnFillRect(const NRectf& rc, const glm::vec4& color)
+{
+    AppendRoundedRect(BeginBatch(BatchType::Fill, color), rc, glm::vec4(0.0f));
+}
+
+void CanvasSVG::OnStroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+{
+    auto& d = BeginBatch(BatchType::Stroke, color, WorldSizeToPixelSize(width));
+    append_point(d, 'M', WorldToPixels(from));
+    append_point(d, 'L', WorldToPixels(to));
+}
+
+void CanvasSVG::OnArc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
+{
+    auto center = WorldToPixels(pos);
+    auto pixelRadius = WorldSizeToPixelSize(radius);
+    auto start = Zest::degToRad(startAngle);
+    auto end = Zest::degToRad(endAngle);
+    auto sweep = end - start;
+
+    auto& d = BeginBatch(BatchType::Stroke, color, WorldSizeToPixelSize(width));
+    auto startPos = center + glm::vec2(std::cos(start), std::sin(start)) * pixelRadius;
+    append_point(d, 'M', startPos);
+
+    // A full turn has no distinct end point, so it goes as two halves
+    if (std::fabs(sweep) >= glm::pi<float>() * 2.0f - 0.0001f)
+    {
+        append_arc(d, pixelRadius, center * 2.0f - startPos, true, sweep > 0.0f);
+        append_arc(d, pixelRadius, startPos, true, sweep > 0.0f);
+        return;
+    }
+
+    auto endPos = center + glm::vec2(std::cos(end), std::sin(end)) * pixelRadius;
+    append_arc(d, pixelRadius, endPos, std::fabs(sweep) > glm::pi<float>(), sweep > 0.0f);
+}
+
+void CanvasSVG::OnPolyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed)
+{
+    if (points.size() < 2)
+    {
+        return;
+    }
+
+    auto& d = BeginBatch(BatchType::Stroke, color, WorldSizeToPixelSize(width));
+    append_point(d, 'M', WorldToPixels(points[0]));
+    append_point(d, 'L', WorldToPixels(points[1]));
+    for (size_t i = 2; i < points.size(); i++)
+    {
+        auto pt = WorldToPixels(points[i]);
+        d += ' ';
+        append_number(d, pt.x);
+        d += ' ';
+        append_number(d, pt.y);
+    }
+
+    if (closed)
+    {
+        d += 'Z';
+    }
+}
+
+// Joins the fill batch, so it is written clockwise like the rects and circles whichever way it
+// was given; the world to pixel transform only scales and offsets, so the winding is the same
+void CanvasSVG::OnFillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color)
+{
+    float area = 0.0f;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        auto& a = points[i];
+        auto& b = points[(i + 1) % points.size()];
+        area += a.x * b.y - b.x * a.y;
+    }
+
+    auto count = points.size();
+    auto point = [&](size_t i) {
+        return WorldToPixels(area < 0.0f ? points[count - 1 - i] : points[i]);
+    };
+
+    auto& d = BeginBatch(BatchType::Fill, color);
+    append_point(d, 'M', point(0));
+    append_point(d, 'L', point(1));
+    for (size_t i = 2; i < count; i++)
+    {
+        auto pt = point(i);
+        d += ' ';
+        append_number(d, pt.x);
+        d += ' ';
+        append_number(d, pt.y);
+    }
+    d += 'Z';
+}
+
+void CanvasSVG::OnSetAA(bool set)
+{
+    if (set != m_antiAlias)
+    {
+        FlushBatch();
+        m_antiAlias = set;
+    }
+}
+
+void CanvasSVG::OnBeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
+{
+    m_path.clear();
+    append_point(m_path, 'M', WorldToPixels(from));
+    m_pathWidth = WorldSizeToPixelSize(width);
+    m_pathColor = color;
+    m_closePath = false;
+}
+
+void CanvasSVG::OnBeginPath(const glm::vec2& from, const glm::vec4& color)
+{
+    m_path.clear();
+    append_point(m_path, 'M', WorldToPixels(from));
+    m_pathColor = color;
+    m_closePath = false;
+}
+
+void CanvasSVG::OnMoveTo(const glm::vec2& to)
+{
+    m_path.clear();
+    append_point(m_path, 'M', WorldToPixels(to));
+}
+
+void CanvasSVG::OnLineTo(const glm::vec2& to)
+{
+    append_point(m_path, 'L', WorldToPixels(to));
+}
+
+void CanvasSVG::OnClosePath()
+{
+    m_closePath = true;
+}
+
+// Free form fills can wind either way, so they get their own element rather than joining a batch
+void CanvasSVG::OnEndPath()
+{
+    FlushBatch();
+    BeginBatch(BatchType::Fill, m_pathColor) += m_path + "Z";
+    FlushBatch();
+}
+
+void CanvasSVG::OnEndStroke()
+{
+    auto& d = BeginBatch(BatchType::Stroke, m_pathColor, m_pathWidth);
+    d += m_path;
+    if (m_closePath)
+    {
+        d += 'Z';
+    }
+}
+
+void CanvasSVG::OnSetLineCap(LineCap cap)
+{
+    if (cap != m_lineCap)
+    {
+        FlushBatch();
+        m_lineCap = cap;
+    }
+}
+
+} // namespace NodeGraph
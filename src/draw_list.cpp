@@ -0,0 +1,707 @@
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <memory_resource>
+#include <ostream>
+#include <type_traits>
+
+#include <nodegraph/canvas.h>
+#include <nodegraph/draw_list.h>
+
+namespace NodeGraph {
+
+namespace {
+
+// Fixed float arguments of each command, in DrawCmdType order. Polyline and FillConvexPolygon end with
+// a point count, and that many x/y pairs follow. Polylines starts with a run and a point count, then
+// the runs and the points; Cables with a cable count, then the cables.
+const uint32_t DrawCmdArgCount[DrawCmdTypeCount] = {
+    7, // FilledCircle
+    15, // FilledGradientCircle
+    9, // FillRoundedRect
+    8, // FillRect
+    17, // FillGradientRoundedRect
+    20, // FillGradientRoundedRectVarying
+    9, // Stroke
+    10, // Arc
+    0, // SetAA
+    7, // BeginStroke
+    6, // BeginPath
+    2, // MoveTo
+    2, // LineTo
+    0, // SetLineCap
+    0, // ClosePath
+    0, // EndPath
+    0, // EndStroke
+    6, // Polyline
+    7, // Text
+    8, // TextBox
+    19, // Slab
+    5, // FillConvexPolygon
+    2, // Polylines
+    1 // Cables
+};
+
+const uint32_t PolylineRunFloats = 7; // Offset, count, color, width
+const uint32_t CableFloats = 13; // From, tangent, to, tangent, color, width
+
+// Counts are stored as floats, which hold whole numbers exactly up to 2^24
+bool valid_count(float count)
+{
+    return count >= 0.0f && count <= 16777216.0f && count == std::floor(count);
+}
+
+// Bytes from the read position to the end; zero if the stream can't seek
+size_t stream_remaining(std::istream& in)
+{
+    auto pos = in.tellg();
+    if (pos < 0)
+    {
+        return 0;
+    }
+    in.seekg(0, std::ios::end);
+    auto end = in.tellg();
+    in.seekg(pos);
+    return end > pos ? size_t(end - pos) : 0;
+}
+
+template <typename T>
+void write_array(std::ostream& out, const std::vector<T>& vec)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    auto count = uint32_t(vec.size());
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(vec.data()), std::streamsize(vec.size() * sizeof(T)));
+}
+
+template <typename T>
+bool read_array(std::istream& in, std::vector<T>& vec)
+{
+    uint32_t count = 0;
+    if (!in.read(reinterpret_cast<char*>(&count), sizeof(count)))
+    {
+        return false;
+    }
+
+    // The count is checked before anything is allocated for it, so a damaged header can't ask for gigabytes
+    if (size_t(count) > stream_remaining(in) / sizeof(T))
+    {
+        return false;
+    }
+    vec.resize(count);
+    return bool(in.read(reinterpret_cast<char*>(vec.data()), std::streamsize(vec.size() * sizeof(T))));
+}
+
+} // namespace
+
+void DrawList::Clear()
+{
+    // Keep the capacity; lists are re-recorded into over and over
+    m_commands.clear();
+    m_data.clear();
+    m_text.clear();
+    m_viewDependent = false;
+}
+
+bool DrawList::Empty() const
+{
+    return m_commands.empty();
+}
+
+size_t DrawList::Size() const
+{
+    return m_commands.size();
+}
+
+uint64_t DrawList::GetGeneration() const
+{
+    return m_generation;
+}
+
+void DrawList::SetGeneration(uint64_t generation)
+{
+    m_generation = generation;
+}
+
+void DrawList::SetViewDependent(const NRectf& visibleRect)
+{
+    m_viewDependent = true;
+    m_viewRect = visibleRect;
+}
+
+bool DrawList::IsValidForView(const NRectf& visibleRect) const
+{
+    if (!m_viewDependent)
+    {
+        return true;
+    }
+    return m_viewRect.topLeftPx == visibleRect.topLeftPx && m_viewRect.bottomRightPx == visibleRect.bottomRightPx;
+}
+
+DrawCmd& DrawList::Push(DrawCmdType type, uint32_t flags)
+{
+    auto& cmd = m_commands.emplace_back();
+    cmd.type = type;
+    cmd.flags = flags;
+    cmd.dataOffset = uint32_t(m_data.size());
+    cmd.textOffset = NoText;
+    cmd.faceOffset = NoText;
+    return cmd;
+}
+
+void DrawList::PushData(float val)
+{
+    m_data.push_back(val);
+}
+
+void DrawList::PushData(const glm::vec2& val)
+{
+    m_data.push_back(val.x);
+    m_data.push_back(val.y);
+}
+
+void DrawList::PushData(const glm::vec4& val)
+{
+    m_data.push_back(val.x);
+    m_data.push_back(val.y);
+    m_data.push_back(val.z);
+    m_data.push_back(val.w);
+}
+
+void DrawList::PushData(const NRectf& val)
+{
+    PushData(val.topLeftPx);
+    PushData(val.bottomRightPx);
+}
+
+uint32_t DrawList::PushText(const char* pszText)
+{
+    if (pszText == nullptr)
+    {
+        return NoText;
+    }
+
+    auto offset = uint32_t(m_text.size());
+    m_text.insert(m_text.end(), pszText, pszText + strlen(pszText) + 1);
+    return offset;
+}
+
+void DrawList::FilledCircle(const glm::vec2& center, float radius, const glm::vec4& color)
+{
+    Push(DrawCmdType::FilledCircle);
+    PushData(center);
+    PushData(radius);
+    PushData(color);
+}
+
+void DrawList::FilledGradientCircle(const glm::vec2& center, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    Push(DrawCmdType::FilledGradientCircle);
+    PushData(center);
+    PushData(radius);
+    PushData(gradientRange);
+    PushData(startColor);
+    PushData(endColor);
+}
+
+void DrawList::FillRoundedRect(const NRectf& rc, float radius, const glm::vec4& color)
+{
+    Push(DrawCmdType::FillRoundedRect);
+    PushData(rc);
+    PushData(radius);
+    PushData(color);
+}
+
+void DrawList::FillRect(const NRectf& rc, const glm::vec4& color)
+{
+    Push(DrawCmdType::FillRect);
+    PushData(rc);
+    PushData(color);
+}
+
+void DrawList::FillGradientRoundedRect(const NRectf& rc, float radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    Push(DrawCmdType::FillGradientRoundedRect);
+    PushData(rc);
+    PushData(radius);
+    PushData(gradientRange);
+    PushData(startColor);
+    PushData(endColor);
+}
+
+void DrawList::FillGradientRoundedRectVarying(const NRectf& rc, const glm::vec4& radius, const NRectf& gradientRange, const glm::vec4& startColor, const glm::vec4& endColor)
+{
+    Push(DrawCmdType::FillGradientRoundedRectVarying);
+    PushData(rc);
+    PushData(radius);
+    PushData(gradientRange);
+    PushData(startColor);
+    PushData(endColor);
+}
+
+void DrawList::Stroke(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+{
+    Push(DrawCmdType::Stroke);
+    PushData(from);
+    PushData(to);
+    PushData(width);
+    PushData(color);
+}
+
+void DrawList::Arc(const glm::vec2& pos, float radius, float width, const glm::vec4& color, float startAngle, float endAngle)
+{
+    Push(DrawCmdType::Arc);
+    PushData(pos);
+    PushData(radius);
+    PushData(width);
+    PushData(color);
+    PushData(startAngle);
+    PushData(endAngle);
+}
+
+void DrawList::SetAA(bool set)
+{
+    Push(DrawCmdType::SetAA, set ? 1 : 0);
+}
+
+void DrawList::BeginStroke(const glm::vec2& from, float width, const glm::vec4& color)
+{
+    Push(DrawCmdType::BeginStroke);
+    PushData(from);
+    PushData(width);
+    PushData(color);
+}
+
+void DrawList::BeginPath(const glm::vec2& from, const glm::vec4& color)
+{
+    Push(DrawCmdType::BeginPath);
+    PushData(from);
+    PushData(color);
+}
+
+void DrawList::MoveTo(const glm::vec2& to)
+{
+    Push(DrawCmdType::MoveTo);
+    PushData(to);
+}
+
+void DrawList::LineTo(const glm::vec2& to)
+{
+    Push(DrawCmdType::LineTo);
+    PushData(to);
+}
+
+void DrawList::SetLineCap(LineCap cap)
+{
+    Push(DrawCmdType::SetLineCap, uint32_t(cap));
+}
+
+void DrawList::ClosePath()
+{
+    Push(DrawCmdType::ClosePath);
+}
+
+void DrawList::EndPath()
+{
+    Push(DrawCmdType::EndPath);
+}
+
+void DrawList::EndStroke()
+{
+    Push(DrawCmdType::EndStroke);
+}
+
+void DrawList::Polyline(std::span<const glm::vec2> points, float width, const glm::vec4& color, bool closed)
+{
+    Push(DrawCmdType::Polyline, closed ? 1 : 0);
+    PushData(width);
+    PushData(color);
+    PushData(float(points.size()));
+    for (auto& pt : points)
+    {
+        PushData(pt);
+    }
+}
+
+void DrawList::FillConvexPolygon(std::span<const glm::vec2> points, const glm::vec4& color)
+{
+    Push(DrawCmdType::FillConvexPolygon);
+    PushData(color);
+    PushData(float(points.size()));
+    for (auto& pt : points)
+    {
+        PushData(pt);
+    }
+}
+
+void DrawList::Polylines(std::span<const glm::vec2> points, std::span<const PolylineRun> runs)
+{
+    Push(DrawCmdType::Polylines);
+    PushData(float(runs.size()));
+    PushData(float(points.size()));
+    for (auto& run : runs)
+    {
+        PushData(float(run.offset));
+        PushData(float(run.count));
+        PushData(run.color);
+        PushData(run.width);
+    }
+    for (auto& pt : points)
+    {
+        PushData(pt);
+    }
+}
+
+void DrawList::Cables(std::span<const CableDesc> cables)
+{
+    Push(DrawCmdType::Cables);
+    PushData(float(cables.size()));
+    for (auto& cable : cables)
+    {
+        PushData(cable.from);
+        PushData(cable.fromTangent);
+        PushData(cable.to);
+        PushData(cable.toTangent);
+        PushData(cable.color);
+        PushData(cable.width);
+    }
+}
+
+void DrawList::Text(const glm::vec2& pos, float size, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    auto textOffset = PushText(pszText);
+    auto faceOffset = PushText(pszFace);
+
+    auto& cmd = Push(DrawCmdType::Text, align);
+    cmd.textOffset = textOffset;
+    cmd.faceOffset = faceOffset;
+    PushData(pos);
+    PushData(size);
+    PushData(color);
+}
+
+void DrawList::TextBox(const glm::vec2& pos, float size, float breakWidth, const glm::vec4& color, const char* pszText, const char* pszFace, uint32_t align)
+{
+    auto textOffset = PushText(pszText);
+    auto faceOffset = PushText(pszFace);
+
+    auto& cmd = Push(DrawCmdType::TextBox, align);
+    cmd.textOffset = textOffset;
+    cmd.faceOffset = faceOffset;
+    PushData(pos);
+    PushData(size);
+    PushData(breakWidth);
+    PushData(color);
+}
+
+void DrawList::Slab(const NRectf& rc, float radius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor)
+{
+    Push(DrawCmdType::Slab);
+    PushData(rc);
+    PushData(radius);
+    PushData(shadowSize);
+    PushData(shadowColor);
+    PushData(borderSize);
+    PushData(borderColor);
+    PushData(centerColor);
+}
+
+void DrawList::Write(std::ostream& out) const
+{
+    write_array(out, m_commands);
+    write_array(out, m_data);
+    write_array(out, m_text);
+}
+
+bool DrawList::Read(std::istream& in)
+{
+    Clear();
+    if (!read_array(in, m_commands) || !read_array(in, m_data) || !read_array(in, m_text))
+    {
+        Clear();
+        return false;
+    }
+
+    // Replay doesn't bounds check, so a damaged trace is rejected here instead
+    auto validText = [&](uint32_t offset) {
+        return offset == NoText || offset < m_text.size();
+    };
+    auto validData = [&](const DrawCmd& cmd) {
+        auto pArgs = m_data.data() + cmd.dataOffset;
+        auto end = size_t(cmd.dataOffset) + DrawCmdArgCount[size_t(cmd.type)];
+        if (end > m_data.size())
+        {
+            return false;
+        }
+
+        // Then whatever the counts in the fixed arguments say follows them
+        auto fits = [&](float count, uint32_t floatsEach) {
+            if (!valid_count(count) || end + size_t(count) * floatsEach > m_data.size())
+            {
+                return false;
+            }
+            end += size_t(count) * floatsEach;
+            return true;
+        };
+
+        switch (cmd.type)
+        {
+        case DrawCmdType::Polyline:
+        case DrawCmdType::FillConvexPolygon:
+            return fits(m_data[end - 1], 2);
+        case DrawCmdType::Polylines:
+        {
+            auto pRuns = pArgs + 2;
+            if (!fits(pArgs[0], PolylineRunFloats) || !fits(pArgs[1], 2))
+            {
+                return false;
+            }
+
+            // Every run has to be inside the points
+            for (size_t run = 0; run < size_t(pArgs[0]); run++)
+            {
+                auto offset = pRuns[run * PolylineRunFloats];
+                auto count = pRuns[run * PolylineRunFloats + 1];
+                if (!valid_count(offset) || !valid_count(count) || offset + count > pArgs[1])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case DrawCmdType::Cables:
+            return fits(pArgs[0], CableFloats);
+        case DrawCmdType::SetLineCap:
+            // No arguments; the cap is in the flags, and is passed straight to the backend
+            return cmd.flags == uint32_t(LineCap::ROUND) || cmd.flags == uint32_t(LineCap::BUTT);
+        default:
+            return true;
+        }
+    };
+
+    bool valid = m_text.empty() || m_text.back() == 0;
+    for (auto& cmd : m_commands)
+    {
+        valid = valid && size_t(cmd.type) < DrawCmdTypeCount && validData(cmd) && validText(cmd.textOffset) && validText(cmd.faceOffset);
+    }
+
+    if (!valid)
+    {
+        Clear();
+    }
+    return valid;
+}
+
+void DrawList::Replay(Canvas& canvas) const
+{
+    for (auto& cmd : m_commands)
+    {
+        const float* pData = m_data.data() + cmd.dataOffset;
+
+        // Read the arguments back in the order they were pushed
+        auto readFloat = [&]() {
+            return *pData++;
+        };
+        auto readVec2 = [&]() {
+            auto ret = glm::vec2(pData[0], pData[1]);
+            pData += 2;
+            return ret;
+        };
+        auto readVec4 = [&]() {
+            auto ret = glm::vec4(pData[0], pData[1], pData[2], pData[3]);
+            pData += 4;
+            return ret;
+        };
+        auto readRect = [&]() {
+            auto topLeft = readVec2();
+            auto bottomRight = readVec2();
+            return NRectf(topLeft, bottomRight);
+        };
+        auto text = [&](uint32_t offset) -> const char* {
+            return offset == NoText ? nullptr : m_text.data() + offset;
+        };
+
+        switch (cmd.type)
+        {
+        case DrawCmdType::FilledCircle:
+        {
+            auto center = readVec2();
+            auto radius = readFloat();
+            canvas.FilledCircle(center, radius, readVec4());
+        }
+        break;
+        case DrawCmdType::FilledGradientCircle:
+        {
+            auto center = readVec2();
+            auto radius = readFloat();
+            auto range = readRect();
+            auto startColor = readVec4();
+            canvas.FilledGradientCircle(center, radius, range, startColor, readVec4());
+        }
+        break;
+        case DrawCmdType::FillRoundedRect:
+        {
+            auto rc = readRect();
+            auto radius = readFloat();
+            canvas.FillRoundedRect(rc, radius, readVec4());
+        }
+        break;
+        case DrawCmdType::FillRect:
+        {
+            auto rc = readRect();
+            canvas.FillRect(rc, readVec4());
+        }
+        break;
+        case DrawCmdType::FillGradientRoundedRect:
+        {
+            auto rc = readRect();
+            auto radius = readFloat();
+            auto range = readRect();
+            auto startColor = readVec4();
+            canvas.FillGradientRoundedRect(rc, radius, range, startColor, readVec4());
+        }
+        break;
+        case DrawCmdType::FillGradientRoundedRectVarying:
+        {
+            auto rc = readRect();
+            auto radius = readVec4();
+            auto range = readRect();
+            auto startColor = readVec4();
+            canvas.FillGradientRoundedRectVarying(rc, radius, range, startColor, readVec4());
+        }
+        break;
+        case DrawCmdType::Stroke:
+        {
+            auto from = readVec2();
+            auto to = readVec2();
+            auto width = readFloat();
+            canvas.Stroke(from, to, width, readVec4());
+        }
+        break;
+        case DrawCmdType::Arc:
+        {
+            auto pos = readVec2();
+            auto radius = readFloat();
+            auto width = readFloat();
+            auto color = readVec4();
+            auto startAngle = readFloat();
+            canvas.Arc(pos, radius, width, color, startAngle, readFloat());
+        }
+        break;
+        case DrawCmdType::SetAA:
+            canvas.SetAA(cmd.flags != 0);
+            break;
+        case DrawCmdType::BeginStroke:
+        {
+            auto from = readVec2();
+            auto width = readFloat();
+            canvas.BeginStroke(from, width, readVec4());
+        }
+        break;
+        case DrawCmdType::BeginPath:
+        {
+            auto from = readVec2();
+            canvas.BeginPath(from, readVec4());
+        }
+        break;
+        case DrawCmdType::MoveTo:
+            canvas.MoveTo(readVec2());
+            break;
+        case DrawCmdType::LineTo:
+            canvas.LineTo(readVec2());
+            break;
+        case DrawCmdType::SetLineCap:
+            canvas.SetLineCap(LineCap(cmd.flags));
+            break;
+        case DrawCmdType::ClosePath:
+            canvas.ClosePath();
+            break;
+        case DrawCmdType::EndPath:
+            canvas.EndPath();
+            break;
+        case DrawCmdType::EndStroke:
+            canvas.EndStroke();
+            break;
+        case DrawCmdType::Polyline:
+        {
+            auto width = readFloat();
+            auto color = readVec4();
+            auto count = size_t(readFloat());
+
+            // The points are stored as consecutive x/y pairs, so they can be handed back without a copy
+            auto pPoints = reinterpret_cast<const glm::vec2*>(pData);
+            canvas.Polyline(std::span<const glm::vec2>(pPoints, count), width, color, cmd.flags != 0);
+        }
+        break;
+        case DrawCmdType::FillConvexPolygon:
+        {
+            auto color = readVec4();
+            auto count = size_t(readFloat());
+            auto pPoints = reinterpret_cast<const glm::vec2*>(pData);
+            canvas.FillConvexPolygon(std::span<const glm::vec2>(pPoints, count), color);
+        }
+        break;
+        case DrawCmdType::Polylines:
+        {
+            auto runCount = size_t(readFloat());
+            auto pointCount = size_t(readFloat());
+
+            // Runs are rebuilt in frame memory; the points can be handed back as they are
+            std::pmr::vector<PolylineRun> runs(runCount, &canvas.GetFrameArena());
+            for (auto& run : runs)
+            {
+                run.offset = uint32_t(readFloat());
+                run.count = uint32_t(readFloat());
+                run.color = readVec4();
+                run.width = readFloat();
+            }
+            auto pPoints = reinterpret_cast<const glm::vec2*>(pData);
+            canvas.SubmitPolylines(std::span<const glm::vec2>(pPoints, pointCount), runs);
+        }
+        break;
+        case DrawCmdType::Cables:
+        {
+            std::pmr::vector<CableDesc> cables(size_t(readFloat()), &canvas.GetFrameArena());
+            for (auto& cable : cables)
+            {
+                cable.from = readVec2();
+                cable.fromTangent = readVec2();
+                cable.to = readVec2();
+                cable.toTangent = readVec2();
+                cable.color = readVec4();
+                cable.width = readFloat();
+            }
+            canvas.DrawCables(cables);
+        }
+        break;
+        case DrawCmdType::Text:
+        {
+            auto pos = readVec2();
+            auto size = readFloat();
+            canvas.Text(pos, size, readVec4(), text(cmd.textOffset), text(cmd.faceOffset), cmd.flags);
+        }
+        break;
+        case DrawCmdType::TextBox:
+        {
+            auto pos = readVec2();
+            auto size = readFloat();
+            auto breakWidth = readFloat();
+            canvas.TextBox(pos, size, breakWidth, readVec4(), text(cmd.textOffset), text(cmd.faceOffset), cmd.flags);
+        }
+        break;
+        case DrawCmdType::Slab:
+        {
+            auto rc = readRect();
+            auto radius = readFloat();
+            auto shadowSize = readFloat();
+            auto shadowColor = readVec4();
+            auto borderSize = readFloat();
+            auto borderColor = readVec4();
+            canvas.Slab(rc, radius, shadowSize, shadowColor, borderSize, borderColor, readVec4());
+        }
+        break;
+        }
+    }
+}
+
+} // namespace NodeGraph
@@ -16,12 +16,7 @@ namespace NodeGraph {
 
 namespace {
 
-struct NVGvertex
-{
-    float x, y, u, v;
-};
-typedef struct NVGvertex NVGvertex;
-std::vector<NVGvertex> vertices;
+using NVGvertex = FontVertex;
 
 struct NVGscissor
 {
@@ -65,8 +60,8 @@ int is_transform_flipped(const float* xform)
 
 NVGvertex* alloc_temp_verts(FontContext& ctx, size_t size)
 {
-    vertices.resize(size);
-    return &vertices[0];
+    ctx.vertices.resize(size);
+    return &ctx.vertices[0];
 }
 
 // Texture handling bits using the imgui API
@@ -92,6 +87,13 @@ void get_texture_size(FontContext& ctx, int image, int* w, int* h)
 
 void render_text(FontContext& ctx, NVGvertex* verts, int nverts, uint32_t color)
 {
+    // Non ImGui backends read the glyphs straight from the atlas
+    if (ctx.fnRenderText)
+    {
+        ctx.fnRenderText(verts, nverts, color);
+        return;
+    }
+
     auto pDraw = ImGui::GetWindowDrawList();
     auto image = ctx.fontImages[ctx.fontImageIdx];
     if (image == 0)
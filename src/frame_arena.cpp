@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <cstdint>
+
+#include <nodegraph/frame_arena.h>
+
+namespace NodeGraph {
+
+FrameArena::FrameArena(size_t blockSize)
+{
+    AddBlock(blockSize);
+}
+
+void FrameArena::Reset()
+{
+    // Last frame overflowed; replace the chain with one block that holds all of it
+    if (m_blocks.size() > 1)
+    {
+        size_t total = 0;
+        for (auto& block : m_blocks)
+        {
+            total += block.size;
+        }
+        m_blocks.clear();
+        AddBlock(total);
+    }
+    m_offset = 0;
+    m_bytesUsed = 0;
+}
+
+size_t FrameArena::GetBytesUsed() const
+{
+    return m_bytesUsed;
+}
+
+void FrameArena::AddBlock(size_t size)
+{
+    Block block;
+    block.spData = std::make_unique<std::byte[]>(size);
+    block.size = size;
+    m_blocks.push_back(std::move(block));
+    m_offset = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    auto align = [&](size_t offset) {
+        auto base = reinterpret_cast<uintptr_t>(m_blocks.back().spData.get());
+        return ((base + offset + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+    };
+
+    auto offset = align(m_offset);
+    if (offset + bytes > m_blocks.back().size)
+    {
+        AddBlock(std::max(bytes + alignment, m_blocks.back().size * 2));
+        offset = align(0);
+    }
+
+    m_offset = offset + bytes;
+    m_bytesUsed += bytes;
+    return m_blocks.back().spData.get() + offset;
+}
+
+void FrameArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    /* Released in bulk by Reset */
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace NodeGraph
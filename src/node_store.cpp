@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cassert>
+#include <istream>
+#include <ostream>
+
+#include <nodegraph/node_store.h>
+
+namespace NodeGraph {
+
+namespace {
+
+const uint32_t StoreMagic = 0x5453474E; // 'NGST'
+const uint32_t StoreVersion = 1;
+
+// One node as it is written; the parent is a position in the written order, which is pre-order
+struct StoredNode
+{
+    glm::vec4 rect;
+    uint64_t flags;
+    uint32_t parent;
+    uint32_t pad;
+};
+
+// Bytes from the read position to the end; zero if the stream can't seek
+size_t stream_remaining(std::istream& in)
+{
+    auto pos = in.tellg();
+    if (pos < 0)
+    {
+        return 0;
+    }
+    in.seekg(0, std::ios::end);
+    auto end = in.tellg();
+    in.seekg(pos);
+    return end > pos ? size_t(end - pos) : 0;
+}
+
+bool overlaps(const NRectf& a, const NRectf& b)
+{
+    return !(a.Right() < b.Left() || a.Left() > b.Right() || a.Bottom() < b.Top() || a.Top() > b.Bottom());
+}
+
+} // namespace
+
+NodeHandle NodeStore::Add(const NRectf& worldRect, NodeHandle parent, Widget* pWidget)
+{
+    assert(parent.index == NodeHandle::InvalidIndex || IsValid(parent));
+
+    uint32_t slot;
+    if (!m_freeSlots.empty())
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slot = uint32_t(m_rects.size());
+        m_rects.emplace_back();
+        m_flags.push_back(0);
+        m_z.push_back(0);
+        m_parents.push_back(NodeHandle::InvalidIndex);
+        m_generations.push_back(0);
+        m_alive.push_back(0);
+        m_widgets.push_back(nullptr);
+    }
+
+    // New nodes go in front of their siblings, the same as being added to the end of a layout
+    m_rects[slot] = worldRect;
+    m_flags[slot] = 0;
+    m_z[slot] = ++m_frontZ;
+    m_parents[slot] = parent.index;
+    m_alive[slot] = 1;
+    m_widgets[slot] = pWidget;
+    m_structureDirty = true;
+
+    return NodeHandle{ slot, m_generations[slot] };
+}
+
+void NodeStore::Remove(NodeHandle node)
+{
+    if (!IsValid(node))
+    {
+        return;
+    }
+
+    EnsurePreOrder();
+
+    auto begin = m_preOrderPos[node.index];
+    auto end = m_subtreeEnd[begin];
+    for (auto pos = begin; pos < end; pos++)
+    {
+        auto slot = m_preOrder[pos];
+        m_alive[slot] = 0;
+        m_widgets[slot] = nullptr;
+        m_generations[slot]++;
+        m_freeSlots.push_back(slot);
+    }
+    m_structureDirty = true;
+}
+
+void NodeStore::Clear()
+{
+    m_rects.clear();
+    m_flags.clear();
+    m_z.clear();
+    m_parents.clear();
+    m_generations.clear();
+    m_alive.clear();
+    m_widgets.clear();
+    m_freeSlots.clear();
+    m_frontZ = 0;
+    m_preOrder.clear();
+    m_subtreeEnd.clear();
+    m_preOrderPos.clear();
+    m_structureDirty = true;
+}
+
+bool NodeStore::IsValid(NodeHandle node) const
+{
+    return node.index < m_alive.size() && m_alive[node.index] && m_generations[node.index] == node.generation;
+}
+
+size_t NodeStore::Size() const
+{
+    return m_rects.size() - m_freeSlots.size();
+}
+
+const NRectf& NodeStore::GetRect(NodeHandle node) const
+{
+    assert(IsValid(node));
+    return m_rects[node.index];
+}
+
+void NodeStore::SetRect(NodeHandle node, const NRectf& worldRect)
+{
+    assert(IsValid(node));
+    m_rects[node.index] = worldRect;
+}
+
+uint64_t NodeStore::GetFlags(NodeHandle node) const
+{
+    assert(IsValid(node));
+    return m_flags[node.index];
+}
+
+void NodeStore::SetFlags(NodeHandle node, uint64_t flags)
+{
+    assert(IsValid(node));
+    m_flags[node.index] = flags;
+}
+
+NodeHandle NodeStore::GetParent(NodeHandle node) const
+{
+    assert(IsValid(node));
+    return HandleAt(m_parents[node.index]);
+}
+
+Widget* NodeStore::GetWidget(NodeHandle node) const
+{
+    assert(IsValid(node));
+    return m_widgets[node.index];
+}
+
+void NodeStore::Raise(NodeHandle node)
+{
+    assert(IsValid(node));
+    m_z[node.index] = ++m_frontZ;
+    m_structureDirty = true;
+}
+
+NodeHandle NodeStore::HandleAt(uint32_t index) const
+{
+    if (index >= m_alive.size() || !m_alive[index])
+    {
+        return NodeHandle();
+    }
+    return NodeHandle{ index, m_generations[index] };
+}
+
+std::span<const uint32_t> NodeStore::GetPreOrder()
+{
+    EnsurePreOrder();
+    return m_preOrder;
+}
+
+// Siblings are sorted by z, then the hierarchy is walked depth first with an explicit stack.
+// This is the only part that isn't linear, and it only runs after a structural change.
+void NodeStore::EnsurePreOrder()
+{
+    if (!m_structureDirty)
+    {
+        return;
+    }
+    m_structureDirty = false;
+
+    auto slotCount = uint32_t(m_rects.size());
+
+    // Children grouped by parent, back to front; top level nodes are grouped under slotCount
+    std::vector<uint32_t> sorted;
+    sorted.reserve(Size());
+    for (uint32_t slot = 0; slot < slotCount; slot++)
+    {
+        if (m_alive[slot])
+        {
+            sorted.push_back(slot);
+        }
+    }
+
+    auto parentKey = [&](uint32_t slot) {
+        return m_parents[slot] == NodeHandle::InvalidIndex ? slotCount : m_parents[slot];
+    };
+    std::sort(sorted.begin(), sorted.end(), [&](uint32_t a, uint32_t b) {
+        auto parentA = parentKey(a);
+        auto parentB = parentKey(b);
+        return parentA != parentB ? parentA < parentB : m_z[a] < m_z[b];
+    });
+
+    // First child offsets into the sorted list, per parent
+    std::vector<uint32_t> firstChild(slotCount + 2, 0);
+    for (auto slot : sorted)
+    {
+        firstChild[parentKey(slot) + 1]++;
+    }
+    for (uint32_t i = 1; i < firstChild.size(); i++)
+    {
+        firstChild[i] += firstChild[i - 1];
+    }
+
+    m_preOrder.clear();
+    m_preOrder.reserve(sorted.size());
+    m_subtreeEnd.assign(sorted.size(), 0);
+    m_preOrderPos.assign(slotCount, NodeHandle::InvalidIndex);
+
+    // Each stack entry is a parent and the next of its children to visit
+    struct Frame
+    {
+        uint32_t parent;
+        uint32_t next;
+    };
+    std::vector<Frame> stack;
+    stack.push_back(Frame{ slotCount, firstChild[slotCount] });
+    while (!stack.empty())
+    {
+        auto& frame = stack.back();
+        if (frame.next == firstChild[frame.parent + 1])
+        {
+            if (frame.parent != slotCount)
+            {
+                m_subtreeEnd[m_preOrderPos[frame.parent]] = uint32_t(m_preOrder.size());
+            }
+            stack.pop_back();
+            continue;
+        }
+
+        auto slot = sorted[frame.next++];
+        m_preOrderPos[slot] = uint32_t(m_preOrder.size());
+        m_preOrder.push_back(slot);
+        stack.push_back(Frame{ slot, firstChild[slot] });
+    }
+}
+
+void NodeStore::Cull(const NRectf& worldRect, std::vector<NodeHandle>& visible)
+{
+    EnsurePreOrder();
+
+    visible.clear();
+    auto count = uint32_t(m_preOrder.size());
+    for (uint32_t pos = 0; pos < count;)
+    {
+        auto slot = m_preOrder[pos];
+        if (!overlaps(m_rects[slot], worldRect))
+        {
+            pos = m_subtreeEnd[pos];
+            continue;
+        }
+        visible.push_back(NodeHandle{ slot, m_generations[slot] });
+        pos++;
+    }
+}
+
+void NodeStore::Move(std::span<const NodeHandle> nodes, const glm::vec2& worldDelta)
+{
+    EnsurePreOrder();
+
+    // Subtrees are contiguous in pre-order, so sorted starts let nested selections be skipped
+    std::vector<uint32_t> starts;
+    starts.reserve(nodes.size());
+    for (auto& node : nodes)
+    {
+        if (IsValid(node))
+        {
+            starts.push_back(m_preOrderPos[node.index]);
+        }
+    }
+    std::sort(starts.begin(), starts.end());
+
+    uint32_t movedEnd = 0;
+    for (auto begin : starts)
+    {
+        if (begin < movedEnd)
+        {
+            continue;
+        }
+
+        movedEnd = m_subtreeEnd[begin];
+        for (auto pos = begin; pos < movedEnd; pos++)
+        {
+            auto& rect = m_rects[m_preOrder[pos]];
+            rect.topLeftPx += worldDelta;
+            rect.bottomRightPx += worldDelta;
+        }
+    }
+}
+
+// Children are only hit inside their parent, as with widgets; the last hit in draw order is in front
+NodeHandle NodeStore::HitTest(const glm::vec2& worldPos)
+{
+    EnsurePreOrder();
+
+    auto hit = NodeHandle::InvalidIndex;
+    auto count = uint32_t(m_preOrder.size());
+    for (uint32_t pos = 0; pos < count;)
+    {
+        auto slot = m_preOrder[pos];
+        if (!m_rects[slot].Contains(worldPos))
+        {
+            pos = m_subtreeEnd[pos];
+            continue;
+        }
+        hit = slot;
+        pos++;
+    }
+    return HandleAt(hit);
+}
+
+void NodeStore::Write(std::ostream& out)
+{
+    EnsurePreOrder();
+
+    std::vector<StoredNode> nodes(m_preOrder.size());
+    for (uint32_t pos = 0; pos < nodes.size(); pos++)
+    {
+        auto slot = m_preOrder[pos];
+        auto& rect = m_rects[slot];
+        auto& node = nodes[pos];
+        node.rect = glm::vec4(rect.topLeftPx, rect.bottomRightPx);
+        node.flags = m_flags[slot];
+        node.parent = m_parents[slot] == NodeHandle::InvalidIndex ? NodeHandle::InvalidIndex : m_preOrderPos[m_parents[slot]];
+        node.pad = 0;
+    }
+
+    uint32_t header[3] = { StoreMagic, StoreVersion, uint32_t(nodes.size()) };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(nodes.data()), std::streamsize(nodes.size() * sizeof(StoredNode)));
+}
+
+bool NodeStore::Read(std::istream& in)
+{
+    uint32_t header[3] = { 0, 0, 0 };
+    if (!in.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != StoreMagic || header[1] != StoreVersion)
+    {
+        return false;
+    }
+
+    // The count is checked against what is left before anything is allocated for it
+    if (size_t(header[2]) > stream_remaining(in) / sizeof(StoredNode))
+    {
+        return false;
+    }
+
+    std::vector<StoredNode> nodes(header[2]);
+    if (!in.read(reinterpret_cast<char*>(nodes.data()), std::streamsize(nodes.size() * sizeof(StoredNode))))
+    {
+        return false;
+    }
+
+    // Written in pre-order, so every parent is before its children and positions can be slots
+    Clear();
+    for (uint32_t pos = 0; pos < nodes.size(); pos++)
+    {
+        auto& node = nodes[pos];
+        if (node.parent != NodeHandle::InvalidIndex && node.parent >= pos)
+        {
+            Clear();
+            return false;
+        }
+
+        auto handle = Add(NRectf(node.rect.x, node.rect.y, node.rect.z - node.rect.x, node.rect.w - node.rect.y), HandleAt(node.parent));
+        m_flags[handle.index] = node.flags;
+    }
+    return true;
+}
+
+} // namespace NodeGraph
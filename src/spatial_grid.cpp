@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <nodegraph/spatial_grid.h>
+
+namespace NodeGraph {
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : m_cellSize(cellSize)
+{
+    assert(cellSize > 0.0f);
+}
+
+void SpatialGrid::Clear()
+{
+    m_entries.clear();
+    m_lookup.clear();
+    m_cells.clear();
+    m_frontZ = 0;
+    m_backZ = 0;
+}
+
+size_t SpatialGrid::Size() const
+{
+    return m_entries.size();
+}
+
+glm::ivec2 SpatialGrid::CellCoord(const glm::vec2& pos) const
+{
+    return glm::ivec2(int(std::floor(pos.x / m_cellSize)), int(std::floor(pos.y / m_cellSize)));
+}
+
+uint64_t SpatialGrid::CellKey(int x, int y)
+{
+    return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(y));
+}
+
+void SpatialGrid::AddToCells(uint32_t entryIndex)
+{
+    auto& entry = m_entries[entryIndex];
+
+    // Rects can be inverted while a node is being resized
+    auto topLeft = glm::min(entry.rect.topLeftPx, entry.rect.bottomRightPx);
+    auto bottomRight = glm::max(entry.rect.topLeftPx, entry.rect.bottomRightPx);
+
+    auto minCell = CellCoord(topLeft);
+    auto maxCell = CellCoord(bottomRight);
+    entry.cells = glm::ivec4(minCell.x, minCell.y, maxCell.x, maxCell.y);
+
+    for (int y = minCell.y; y <= maxCell.y; y++)
+    {
+        for (int x = minCell.x; x <= maxCell.x; x++)
+        {
+            m_cells[CellKey(x, y)].push_back(entryIndex);
+        }
+    }
+}
+
+void SpatialGrid::RemoveFromCells(uint32_t entryIndex)
+{
+    const auto& cells = m_entries[entryIndex].cells;
+    for (int y = cells.y; y <= cells.w; y++)
+    {
+        for (int x = cells.x; x <= cells.z; x++)
+        {
+            auto itr = m_cells.find(CellKey(x, y));
+            if (itr == m_cells.end())
+            {
+                continue;
+            }
+
+            auto& bucket = itr->second;
+            auto itrFound = std::find(bucket.begin(), bucket.end(), entryIndex);
+            if (itrFound != bucket.end())
+            {
+                *itrFound = bucket.back();
+                bucket.pop_back();
+            }
+
+            if (bucket.empty())
+            {
+                m_cells.erase(itr);
+            }
+        }
+    }
+}
+
+void SpatialGrid::Update(Widget* pWidget, const NRectf& worldRect)
+{
+    auto itr = m_lookup.find(pWidget);
+    if (itr == m_lookup.end())
+    {
+        // New widgets go in front, the same as being added to the end of a layout
+        auto entryIndex = uint32_t(m_entries.size());
+        auto& entry = m_entries.emplace_back();
+        entry.pWidget = pWidget;
+        entry.rect = worldRect;
+        entry.z = ++m_frontZ;
+        m_lookup[pWidget] = entryIndex;
+        AddToCells(entryIndex);
+        return;
+    }
+
+    auto& entry = m_entries[itr->second];
+    if (entry.rect.topLeftPx == worldRect.topLeftPx && entry.rect.bottomRightPx == worldRect.bottomRightPx)
+    {
+        return;
+    }
+
+    // Only touch the buckets if the widget crossed a cell boundary
+    entry.rect = worldRect;
+    auto minCell = CellCoord(glm::min(worldRect.topLeftPx, worldRect.bottomRightPx));
+    auto maxCell = CellCoord(glm::max(worldRect.topLeftPx, worldRect.bottomRightPx));
+    if (entry.cells != glm::ivec4(minCell.x, minCell.y, maxCell.x, maxCell.y))
+    {
+        RemoveFromCells(itr->second);
+        AddToCells(itr->second);
+    }
+}
+
+void SpatialGrid::Remove(Widget* pWidget)
+{
+    auto itr = m_lookup.find(pWidget);
+    if (itr == m_lookup.end())
+    {
+        return;
+    }
+
+    auto entryIndex = itr->second;
+    auto lastIndex = uint32_t(m_entries.size() - 1);
+    RemoveFromCells(entryIndex);
+    m_lookup.erase(itr);
+
+    // Swap the last entry into the hole, and re-bucket it under its new index
+    if (entryIndex != lastIndex)
+    {
+        RemoveFromCells(lastIndex);
+        m_entries[entryIndex] = m_entries[lastIndex];
+        m_lookup[m_entries[entryIndex].pWidget] = entryIndex;
+        AddToCells(entryIndex);
+    }
+    m_entries.pop_back();
+}
+
+void SpatialGrid::Raise(Widget* pWidget)
+{
+    auto itr = m_lookup.find(pWidget);
+    if (itr != m_lookup.end())
+    {
+        m_entries[itr->second].z = ++m_frontZ;
+    }
+}
+
+void SpatialGrid::Lower(Widget* pWidget)
+{
+    auto itr = m_lookup.find(pWidget);
+    if (itr != m_lookup.end())
+    {
+        m_entries[itr->second].z = --m_backZ;
+    }
+}
+
+void SpatialGrid::Query(const glm::vec2& worldPos, std::vector<Widget*>& results) const
+{
+    results.clear();
+
+    auto cell = CellCoord(worldPos);
+    auto itr = m_cells.find(CellKey(cell.x, cell.y));
+    if (itr == m_cells.end())
+    {
+        return;
+    }
+
+    // Buckets are small, so a sort of the hits is cheaper than keeping them ordered
+    m_hits.clear();
+    for (auto entryIndex : itr->second)
+    {
+        const auto& entry = m_entries[entryIndex];
+        if (entry.rect.Contains(worldPos))
+        {
+            m_hits.push_back(&entry);
+        }
+    }
+
+    std::sort(m_hits.begin(), m_hits.end(), [](const Entry* pLeft, const Entry* pRight) {
+        return pLeft->z > pRight->z;
+    });
+
+    for (auto& pEntry : m_hits)
+    {
+        results.push_back(pEntry->pWidget);
+    }
+}
+
+} // namespace NodeGraph
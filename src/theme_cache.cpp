@@ -0,0 +1,72 @@
+#include <nodegraph/theme.h>
+#include <nodegraph/theme_cache.h>
+
+namespace NodeGraph {
+
+void ThemeCache::Resolve(const Zest::StringId& theme)
+{
+    auto& settings = Zest::GlobalSettingsManager::Instance();
+
+    gridLineSize = settings.GetVec2f(theme, s_gridLineSize);
+    gridLines = settings.GetVec4f(theme, c_gridLines);
+    nodeBorderRadius = settings.GetFloat(theme, s_nodeBorderRadius);
+    nodeShadowSize = settings.GetFloat(theme, s_nodeShadowSize);
+    nodeBorderSize = settings.GetFloat(theme, s_nodeBorderSize);
+    nodeShadowColor = settings.GetVec4f(theme, c_nodeShadowColor);
+    nodeCenterColor = settings.GetVec4f(theme, c_nodeCenterColor);
+    nodeBorderColor = settings.GetVec4f(theme, c_nodeBorderColor);
+    nodeTitleSize = settings.GetFloat(theme, s_nodeTitleSize);
+    nodeTitleFontPad = settings.GetFloat(theme, s_nodeTitleFontPad);
+    nodeTitleBorder = settings.GetFloat(theme, s_nodeTitleBorder);
+    nodeTitleBorderRadius = settings.GetFloat(theme, s_nodeTitleBorderRadius);
+    nodeTitlePad = settings.GetFloat(theme, s_nodeTitlePad);
+    nodeTitleShadowSize = settings.GetFloat(theme, s_nodeTitleShadowSize);
+    nodeTitleBorderSize = settings.GetFloat(theme, s_nodeTitleBorderSize);
+    nodeTitleShadowColor = settings.GetVec4f(theme, c_nodeTitleShadowColor);
+    nodeTitleCenterColor = settings.GetVec4f(theme, c_nodeTitleCenterColor);
+    nodeTitleBorderColor = settings.GetVec4f(theme, c_nodeTitleBorderColor);
+    sliderBorderSize = settings.GetFloat(theme, s_sliderBorderSize);
+    sliderThumbPad = settings.GetFloat(theme, s_sliderThumbPad);
+    sliderThumbShadowSize = settings.GetFloat(theme, s_sliderThumbShadowSize);
+    sliderThumbRadius = settings.GetFloat(theme, s_sliderThumbRadius);
+    sliderThumbShadowColor = settings.GetVec4f(theme, c_sliderThumbShadowColor);
+    sliderThumbColor = settings.GetVec4f(theme, c_sliderThumbColor);
+    sliderBorderRadius = settings.GetFloat(theme, s_sliderBorderRadius);
+    sliderShadowSize = settings.GetFloat(theme, s_sliderShadowSize);
+    sliderFontPad = settings.GetFloat(theme, s_sliderFontPad);
+    sliderBorderColor = settings.GetVec4f(theme, c_sliderBorderColor);
+    sliderCenterColor = settings.GetVec4f(theme, c_sliderCenterColor);
+    sliderShadowColor = settings.GetVec4f(theme, c_sliderShadowColor);
+    sliderTipBorderRadius = settings.GetFloat(theme, s_sliderTipBorderRadius);
+    sliderTipShadowSize = settings.GetFloat(theme, s_sliderTipShadowSize);
+    sliderTipFontPad = settings.GetFloat(theme, s_sliderTipFontPad);
+    sliderTipFontSize = settings.GetFloat(theme, s_sliderTipFontSize);
+    sliderTipBorderSize = settings.GetFloat(theme, s_sliderTipBorderSize);
+    sliderTipBorderColor = settings.GetVec4f(theme, c_sliderTipBorderColor);
+    sliderTipCenterColor = settings.GetVec4f(theme, c_sliderTipCenterColor);
+    sliderTipShadowColor = settings.GetVec4f(theme, c_sliderTipShadowColor);
+    sliderTipFontColor = settings.GetVec4f(theme, c_sliderTipFontColor);
+    labelColor = settings.GetVec4f(theme, c_labelColor);
+    knobChannelColor = settings.GetVec4f(theme, c_knobChannelColor);
+    knobShadowColor = settings.GetVec4f(theme, c_knobShadowColor);
+    knobChannelHLColor = settings.GetVec4f(theme, c_knobChannelHLColor);
+    knobMarkColor = settings.GetVec4f(theme, c_knobMarkColor);
+    knobMarkHLColor = settings.GetVec4f(theme, c_knobMarkHLColor);
+    knobFillColor = settings.GetVec4f(theme, c_knobFillColor);
+    knobFillHLColor = settings.GetVec4f(theme, c_knobFillHLColor);
+    knobTextColor = settings.GetVec4f(theme, c_knobTextColor);
+    knobChannelWidth = settings.GetFloat(theme, s_knobChannelWidth);
+    knobChannelGap = settings.GetFloat(theme, s_knobChannelGap);
+    knobShadowSize = settings.GetFloat(theme, s_knobShadowSize);
+    knobTextSize = settings.GetFloat(theme, s_knobTextSize);
+    knobTextInset = settings.GetFloat(theme, s_knobTextInset);
+    debugShowLayout = settings.GetBool(theme, b_debugShowLayout);
+    socketColor = settings.GetVec4f(theme, c_socketColor);
+    socketShadowColor = settings.GetVec4f(theme, c_socketShadowColor);
+    waveSliderCenterColor = settings.GetVec4f(theme, c_waveSliderCenterColor);
+    waveSliderBorderColor = settings.GetVec4f(theme, c_waveSliderBorderColor);
+    lodNodeTitlePixels = settings.GetFloat(theme, s_lodNodeTitlePixels);
+    lodCableCurvePixels = settings.GetFloat(theme, s_lodCableCurvePixels);
+}
+
+} // namespace NodeGraph
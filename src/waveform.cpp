@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <cmath>
+
+#include <nodegraph/waveform.h>
+
+namespace NodeGraph {
+
+void Waveform::Clear()
+{
+    m_samples.clear();
+    m_levels.clear();
+}
+
+void Waveform::Set(std::span<const float> samples)
+{
+    Clear();
+    Append(samples);
+}
+
+void Waveform::Append(std::span<const float> samples)
+{
+    if (samples.empty())
+    {
+        return;
+    }
+
+    auto firstSample = m_samples.size();
+    m_samples.insert(m_samples.end(), samples.begin(), samples.end());
+    UpdateLevels(firstSample);
+}
+
+size_t Waveform::GetSampleCount() const
+{
+    return m_samples.size();
+}
+
+bool Waveform::Empty() const
+{
+    return m_samples.empty();
+}
+
+// Everything before the bin holding firstSample is complete and stays as it is
+void Waveform::UpdateLevels(size_t firstSample)
+{
+    if (m_levels.empty())
+    {
+        m_levels.emplace_back();
+    }
+
+    auto firstBin = firstSample / BinSamples;
+    auto& base = m_levels[0];
+    base.resize((m_samples.size() + BinSamples - 1) / BinSamples);
+    for (size_t bin = firstBin; bin < base.size(); bin++)
+    {
+        auto begin = bin * BinSamples;
+        auto end = std::min(begin + BinSamples, m_samples.size());
+
+        Bin summary{ m_samples[begin], m_samples[begin], 0.0f };
+        for (size_t i = begin; i < end; i++)
+        {
+            auto sample = m_samples[i];
+            summary.minimum = std::min(summary.minimum, sample);
+            summary.maximum = std::max(summary.maximum, sample);
+            summary.squares += sample * sample;
+        }
+        base[bin] = summary;
+    }
+
+    // Each level merges pairs from the one below, up to a single bin over everything
+    for (size_t level = 1; m_levels[level - 1].size() > 1; level++)
+    {
+        if (m_levels.size() <= level)
+        {
+            m_levels.emplace_back();
+        }
+
+        auto& below = m_levels[level - 1];
+        auto& current = m_levels[level];
+        firstBin /= 2;
+        current.resize((below.size() + 1) / 2);
+        for (size_t bin = firstBin; bin < current.size(); bin++)
+        {
+            auto summary = below[bin * 2];
+            if (bin * 2 + 1 < below.size())
+            {
+                auto& next = below[bin * 2 + 1];
+                summary.minimum = std::min(summary.minimum, next.minimum);
+                summary.maximum = std::max(summary.maximum, next.maximum);
+                summary.squares += next.squares;
+            }
+            current[bin] = summary;
+        }
+    }
+}
+
+void Waveform::Summarize(size_t begin, size_t end, uint32_t columns, std::vector<WaveformBin>& bins) const
+{
+    end = std::min(end, m_samples.size());
+    if (columns == 0 || begin >= end)
+    {
+        bins.clear();
+        return;
+    }
+    bins.resize(columns);
+
+    // The coarsest level whose bins still fit inside a column; none when a column is smaller than a bin
+    auto samplesPerColumn = double(end - begin) / double(columns);
+    int level = -1;
+    size_t binSize = 0;
+    while (level + 1 < int(m_levels.size()) && double(size_t(BinSamples) << (level + 1)) <= samplesPerColumn)
+    {
+        level++;
+        binSize = size_t(BinSamples) << level;
+    }
+
+    for (uint32_t column = 0; column < columns; column++)
+    {
+        auto from = begin + size_t(double(column) * samplesPerColumn);
+        auto to = std::clamp(begin + size_t(double(column + 1) * samplesPerColumn), from + 1, end);
+
+        Bin summary{ 0.0f, 0.0f, 0.0f };
+        size_t count = 0;
+        if (level < 0)
+        {
+            // Fewer than a bin's worth of samples; read them directly
+            summary = Bin{ m_samples[from], m_samples[from], 0.0f };
+            for (auto i = from; i < to; i++)
+            {
+                auto sample = m_samples[i];
+                summary.minimum = std::min(summary.minimum, sample);
+                summary.maximum = std::max(summary.maximum, sample);
+                summary.squares += sample * sample;
+            }
+            count = to - from;
+        }
+        else
+        {
+            // Between one and three bins, since a column is less than two bins wide
+            auto& levelBins = m_levels[level];
+            auto firstBin = from / binSize;
+            auto lastBin = std::min((to - 1) / binSize, levelBins.size() - 1);
+            summary = levelBins[firstBin];
+            for (auto bin = firstBin + 1; bin <= lastBin; bin++)
+            {
+                summary.minimum = std::min(summary.minimum, levelBins[bin].minimum);
+                summary.maximum = std::max(summary.maximum, levelBins[bin].maximum);
+                summary.squares += levelBins[bin].squares;
+            }
+            count = std::min((lastBin + 1) * binSize, m_samples.size()) - firstBin * binSize;
+        }
+
+        auto& out = bins[column];
+        out.minimum = summary.minimum;
+        out.maximum = summary.maximum;
+        out.rms = std::sqrt(summary.squares / float(count));
+    }
+}
+
+} // namespace NodeGraph
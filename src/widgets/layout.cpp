@@ -1,6 +1,7 @@
 #include <zest/logger/logger.h>
 
 #include <nodegraph/canvas.h>
+#include <nodegraph/spatial_grid.h>
 #include <nodegraph/theme.h>
 #include <nodegraph/widgets/layout.h>
 
@@ -53,18 +54,26 @@ float Layout::SpaceForWidgets(size_t count) const
     return spacing;
 }
 
-tWidgets Layout::GetNonFixedWidgets() const
+// Filled into a list kept on the layout, so it only allocates when the child count grows
+const std::vector<Widget*>& Layout::GetNonFixedWidgets() const
 {
-    tWidgets ret;
-    std::copy_if(m_children.begin(), m_children.end(), std::back_inserter(ret), [](auto pWidget) {
-        return !(pWidget->GetFlags() & WidgetFlags::DoNotLayout);
-    });
-    return ret;
+    m_layoutWidgets.clear();
+    for (auto& spWidget : m_children)
+    {
+        if (!(spWidget->GetFlags() & WidgetFlags::DoNotLayout))
+        {
+            m_layoutWidgets.push_back(spWidget.get());
+        }
+    }
+    return m_layoutWidgets;
 }
 
 void Layout::Update()
 {
-    tWidgets layoutWidgets = GetNonFixedWidgets();
+    // Anything invalidated while the children are being arranged is picked up on the next pass
+    m_layoutValid = true;
+
+    auto& layoutWidgets = GetNonFixedWidgets();
     if (layoutWidgets.empty())
     {
         return;
@@ -139,6 +148,7 @@ void Layout::Update()
     // Rect is the max minor axis size + content margins
     // Major axis is whatever it was before
     m_rect = layoutRect;
+    InvalidateWorldRect();
 
     // Layout rect is now the inner rect; in child rect coordinates
     layoutRect = NRectf(0.0f, 0.0f, layoutRect.Width(), layoutRect.Height());
@@ -149,6 +159,7 @@ void Layout::Update()
     m_innerRect = layoutRect.Adjusted(m_rect.TopLeft());
 
     // Resize all the widgets to fit
+    m_arranging = true;
     float expandingWidgetSize = (availableSize - spacingSize) / variableCount;
     for (int i = 0; i < layoutWidgets.size(); i++)
     {
@@ -175,22 +186,114 @@ void Layout::Update()
         }
         pWidget->SetRectWithPad(widgetRect);
     }
+    m_arranging = false;
 }
 
-void Layout::SetRect(const NRectf& sz)
+// Owners set the rect every time they draw; nothing is re-measured or moved unless it changed,
+// or something below was invalidated
+void Layout::Arrange(const NRectf& rc)
 {
-    Widget::SetRect(sz);
+    if (m_layoutValid && rc.topLeftPx == m_arrangedRect.topLeftPx && rc.bottomRightPx == m_arrangedRect.bottomRightPx)
+    {
+        return;
+    }
+    m_arrangedRect = rc;
 
+    Widget::SetRect(rc);
     Update();
+
+    // A child's first rect gives it a size hint, which invalidates this layout part way through the pass;
+    // settle it now, and if it still moves, have the owner recorded again next frame with the result
+    if (!m_layoutValid)
+    {
+        Update();
+        if (!m_layoutValid)
+        {
+            MarkDirty();
+        }
+    }
+}
+
+void Layout::SetRect(const NRectf& sz)
+{
+    Arrange(sz);
 }
 
 void Layout::SetRectWithPad(const NRectf& rc)
 {
     auto cm = GetContentsMargins();
-    auto newRc = rc.Adjusted(glm::vec4(cm.x, cm.y, -cm.z, -cm.w));
-    Widget::SetRect(newRc);
+    Arrange(rc.Adjusted(glm::vec4(cm.x, cm.y, -cm.z, -cm.w)));
+}
 
-    Update();
+void Layout::InvalidateLayout()
+{
+    if (m_holdNotifications)
+    {
+        std::lock_guard<std::mutex> lock(m_heldMutex);
+        m_heldInvalidate = true;
+        return;
+    }
+    m_layoutValid = false;
+    m_childrenHintValid = false;
+    Widget::InvalidateLayout();
+}
+
+Layout* Layout::AsLayout()
+{
+    return this;
+}
+
+void Layout::MarkDirty()
+{
+    if (m_holdNotifications)
+    {
+        std::lock_guard<std::mutex> lock(m_heldMutex);
+        m_heldDirty = true;
+        return;
+    }
+    Widget::MarkDirty();
+}
+
+void Layout::SetHoldNotifications(bool hold)
+{
+    m_holdNotifications = hold;
+    if (hold)
+    {
+        return;
+    }
+
+    // Everything that was held is replayed as if it had just arrived
+    for (auto pChild : m_heldRectChanges)
+    {
+        ChildRectChanged(pChild);
+    }
+    m_heldRectChanges.clear();
+
+    if (m_heldInvalidate)
+    {
+        m_heldInvalidate = false;
+        InvalidateLayout();
+    }
+
+    if (m_heldDirty)
+    {
+        m_heldDirty = false;
+        MarkDirty();
+    }
+}
+
+void Layout::InvalidateWorldRect()
+{
+    if (!m_worldRectValid)
+    {
+        return;
+    }
+
+    Widget::InvalidateWorldRect();
+    for (auto& child : m_children)
+    {
+        child->InvalidateWorldRect();
+    }
 }
 
 NRectf Layout::GetRectWithPad() const
@@ -204,38 +307,59 @@ void Layout::AddChild(std::shared_ptr<Widget> spWidget)
     m_children.push_back(spWidget);
     spWidget->SetParent(this);
     SortWidgets();
+    InvalidateLayout();
+    MarkDirty();
+
+    if (m_pSpatialGrid)
+    {
+        m_pSpatialGrid->Update(spWidget.get(), spWidget->GetWorldRect());
+    }
 }
 
-void Layout::MoveChildToBack(std::shared_ptr<Widget> pWidget)
+void Layout::MoveChildToBack(Widget* pWidget)
 {
     auto itr = std::find_if(m_children.begin(),
         m_children.end(),
         [&](const auto& pFound) -> bool {
-            return pFound.get() == pWidget.get();
+            return pFound.get() == pWidget;
         });
 
     if (itr != m_children.end())
     {
+        auto spFound = *itr;
         m_children.erase(itr);
-        m_children.insert(m_children.end(), pWidget);
+        m_children.insert(m_children.end(), spFound);
     }
     SortWidgets();
+    InvalidateLayout();
+
+    if (m_pSpatialGrid)
+    {
+        m_pSpatialGrid->Raise(pWidget);
+    }
 }
 
-void Layout::MoveChildToFront(std::shared_ptr<Widget> pWidget)
+void Layout::MoveChildToFront(Widget* pWidget)
 {
     auto itr = std::find_if(m_children.begin(),
         m_children.end(),
         [&](const auto& pFound) -> bool {
-            return pFound.get() == pWidget.get();
+            return pFound.get() == pWidget;
         });
 
     if (itr != m_children.end())
     {
+        auto spFound = *itr;
         m_children.erase(itr);
-        m_children.insert(m_children.begin(), pWidget);
+        m_children.insert(m_children.begin(), spFound);
     }
     SortWidgets();
+    InvalidateLayout();
+
+    if (m_pSpatialGrid)
+    {
+        m_pSpatialGrid->Lower(pWidget);
+    }
 }
 
 const WidgetList& Layout::GetFrontToBack() const
@@ -261,9 +385,8 @@ const WidgetList& Layout::GetChildren() const
 
 void Layout::Draw(Canvas& canvas)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
-    if (settings.GetBool(theme, b_debugShowLayout))
+    auto& theme = canvas.GetTheme();
+    if (theme.debugShowLayout)
     {
         if (m_layoutType == LayoutType::Horizontal)
         {
@@ -276,8 +399,13 @@ void Layout::Draw(Canvas& canvas)
             canvas.FillRect(ToWorldRect(m_rect), glm::vec4(0.5f, 0.2f, 0.5f, 1.0f));
         }
     }
-    for (auto& child : GetLayout()->GetBackToFront())
+    for (auto& child : ChildrenBackToFront())
     {
+        // Cull before the child does any theme lookups or text work
+        if (!canvas.IsVisible(child->GetWorldRect()))
+        {
+            continue;
+        }
         child->Draw(canvas);
     }
 }
@@ -287,9 +415,62 @@ Layout* Layout::GetLayout()
     return this;
 }
 
+Layout* Layout::FindLayout()
+{
+    return this;
+}
+
+std::span<const std::shared_ptr<Widget>> Layout::ChildrenFrontToBack() const
+{
+    return m_frontToBack;
+}
+
+std::span<const std::shared_ptr<Widget>> Layout::ChildrenBackToFront() const
+{
+    return m_children;
+}
+
+void Layout::SetSpatialGrid(SpatialGrid* pGrid)
+{
+    m_pSpatialGrid = pGrid;
+    if (m_pSpatialGrid)
+    {
+        m_pSpatialGrid->Clear();
+        for (auto& child : m_children)
+        {
+            m_pSpatialGrid->Update(child.get(), child->GetWorldRect());
+        }
+    }
+}
+
+void Layout::ChildRectChanged(Widget* pChild)
+{
+    if (m_holdNotifications)
+    {
+        std::lock_guard<std::mutex> lock(m_heldMutex);
+        m_heldRectChanges.push_back(pChild);
+        return;
+    }
+
+    // Moved or resized from outside, rather than by this layout
+    if (!m_arranging)
+    {
+        InvalidateLayout();
+    }
+
+    if (m_pSpatialGrid)
+    {
+        m_pSpatialGrid->Update(pChild, pChild->GetWorldRect());
+    }
+}
+
 void Layout::SetContentsMargins(const glm::vec4& contentsMargins)
 {
-    m_contentsMargins = contentsMargins;
+    if (m_contentsMargins != contentsMargins)
+    {
+        m_contentsMargins = contentsMargins;
+        InvalidateLayout();
+    }
 }
 
 const glm::vec4& Layout::GetContentsMargins() const
@@ -304,26 +485,36 @@ LayoutType Layout::GetLayoutType() const
 
 void Layout::SetSpacing(float val)
 {
-    m_spacing = val;
+    if (m_spacing != val)
+    {
+        m_spacing = val;
+        InvalidateLayout();
+    }
 }
 
 // For the direct children of this layout, get the size hint.
-// This is the required size for the widgets
+// This is the required size for the widgets; cached until the layout is invalidated
 void Layout::GetChildrenSizeHint(SizeHint& hint) const
 {
-    for (auto& spChild : m_children)
+    if (!m_childrenHintValid)
     {
-        if (auto pLayout = dynamic_cast<Layout*>(spChild.get()))
-        {
-            pLayout->GetChildrenSizeHint(hint);
-        }
-        else
+        m_childrenHint = SizeHint();
+        for (auto& spChild : m_children)
         {
-            auto pad = spChild->GetPadding();
-            auto padSize = glm::vec2(pad.x + pad.z, pad.y + pad.w);
-            hint.hint = glm::max(spChild->GetSizeHint() + padSize, hint.hint);
+            if (auto pLayout = spChild->AsLayout())
+            {
+                pLayout->GetChildrenSizeHint(m_childrenHint);
+            }
+            else
+            {
+                auto pad = spChild->GetPadding();
+                auto padSize = glm::vec2(pad.x + pad.z, pad.y + pad.w);
+                m_childrenHint.hint = glm::max(spChild->GetSizeHint() + padSize, m_childrenHint.hint);
+            }
         }
+        m_childrenHintValid = true;
     }
+    hint.hint = glm::max(m_childrenHint.hint, hint.hint);
 }
 
 // Find the range of sizes for the child layout
@@ -333,7 +524,7 @@ glm::vec4 Layout::GetChildrenMinMaxSize() const
     for (auto& spChild : m_children)
     {
         glm::vec4 childMinMax;
-        if (auto pLayout = dynamic_cast<Layout*>(spChild.get()))
+        if (auto pLayout = spChild->AsLayout())
         {
             childMinMax = pLayout->GetChildrenMinMaxSize();
         }
@@ -15,48 +15,58 @@ Node::Node(const std::string& label)
 
 void Node::Draw(Canvas& canvas)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
     Widget::Draw(canvas);
 
     auto rcWorld = GetWorldRect();
 
+    // Zoomed out far enough that the title can't be read; just show where the node is
+    auto fontSize = theme.nodeTitleSize;
+    if (!canvas.IsDetailVisible(fontSize, theme.lodNodeTitlePixels))
+    {
+        canvas.FillRoundedRect(rcWorld, theme.nodeBorderRadius, theme.nodeTitleCenterColor);
+        return;
+    }
+
     rcWorld = DrawSlab(canvas,
         rcWorld,
-        settings.GetFloat(theme, s_nodeBorderRadius),
-        settings.GetFloat(theme, s_nodeShadowSize),
-        settings.GetVec4f(theme, c_nodeShadowColor),
-        settings.GetFloat(theme, s_nodeBorderSize),
-        settings.GetVec4f(theme, c_nodeBorderColor),
-        settings.GetVec4f(theme, c_nodeCenterColor));
+        theme.nodeBorderRadius,
+        theme.nodeShadowSize,
+        theme.nodeShadowColor,
+        theme.nodeBorderSize,
+        theme.nodeBorderColor,
+        theme.nodeCenterColor);
 
-    auto fontSize = settings.GetFloat(theme, s_nodeTitleSize);
-    auto titleHeight = fontSize + settings.GetFloat(theme, s_nodeTitleFontPad) * 2.0f;
-    auto titlePad = settings.GetFloat(theme, s_nodeTitlePad);
+    auto titleHeight = fontSize + theme.nodeTitleFontPad * 2.0f;
+    auto titlePad = theme.nodeTitlePad;
 
     auto titlePanelRect = NRectf(rcWorld.Left() + titlePad, rcWorld.Top() + titlePad, rcWorld.Width() - titlePad * 2.0f, titleHeight);
 
     rcWorld = DrawSlab(canvas,
         titlePanelRect,
-        settings.GetFloat(theme, s_nodeTitleBorderRadius),
-        settings.GetFloat(theme, s_nodeTitleShadowSize),
-        settings.GetVec4f(theme, c_nodeTitleShadowColor),
-        settings.GetFloat(theme, s_nodeTitleBorderSize),
-        settings.GetVec4f(theme, c_nodeTitleBorderColor),
-        settings.GetVec4f(theme, c_nodeTitleCenterColor),
+        theme.nodeTitleBorderRadius,
+        theme.nodeTitleShadowSize,
+        theme.nodeTitleShadowColor,
+        theme.nodeTitleBorderSize,
+        theme.nodeTitleBorderColor,
+        theme.nodeTitleCenterColor,
         m_label.c_str(),
-        settings.GetFloat(theme, s_nodeTitleFontPad),
-        TextColorForBackground(settings.GetVec4f(theme, c_nodeTitleCenterColor)));
+        theme.nodeTitleFontPad,
+        TextColorForBackground(theme.nodeTitleCenterColor));
 
-    auto bottomGap = settings.GetFloat(theme, s_nodeBorderSize) + settings.GetFloat(theme, s_nodeShadowSize);
+    auto bottomGap = theme.nodeBorderSize + theme.nodeShadowSize;
     
     // Layout in child coordinates
     auto layoutRect = NRectf(titlePanelRect.Left(), titlePanelRect.Bottom(), titlePanelRect.Width(), GetWorldRect().Bottom() - bottomGap - titlePanelRect.Bottom());
     layoutRect.Adjust(-GetWorldRect().Left(), -GetWorldRect().Top());
-    GetLayout()->SetRectWithPad(layoutRect);
-    GetLayout()->SetConstraints(glm::uvec2(LayoutConstraint::Preferred, LayoutConstraint::Expanding));
 
-    GetLayout()->Draw(canvas);
+    // A node with nothing added to it has no layout to draw
+    if (auto pLayout = FindLayout())
+    {
+        pLayout->SetRectWithPad(layoutRect);
+        pLayout->SetConstraints(glm::uvec2(LayoutConstraint::Preferred, LayoutConstraint::Expanding));
+        pLayout->Draw(canvas);
+    }
 }
 
 Widget* Node::MouseDown(CanvasInputState& input)
@@ -103,6 +113,14 @@ bool Node::MouseMove(CanvasInputState& input)
         {
             m_rect.Adjust(input.worldMoveDelta);
         }
+        InvalidateWorldRect();
+        MarkDirty();
+
+        // Keep the canvas hit test index in step with the node
+        if (m_pParent)
+        {
+            m_pParent->ChildRectChanged(this);
+        }
         return true;
     }
     return false;
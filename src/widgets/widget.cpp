@@ -1,17 +1,137 @@
 #include <functional>
 
 #include <format>
+#include <iterator>
 
 #include <zest/logger/logger.h>
 
 #include <nodegraph/canvas.h>
+#include <nodegraph/draw_list.h>
 #include <nodegraph/theme.h>
 #include <nodegraph/widgets/layout.h>
 #include <nodegraph/widgets/widget.h>
 
 namespace NodeGraph {
 
-std::unordered_map<Widget*, TipTimer*> TipTimer::ActiveTips;
+TipScheduler::TipScheduler()
+{
+    timer_restart(m_clock);
+}
+
+// Tips can outlive the canvas that animated them; leave them Off and unlinked
+TipScheduler::~TipScheduler()
+{
+    while (m_pFirstActive)
+    {
+        auto pTip = m_pFirstActive;
+        Unlink(pTip);
+        pTip->m_state = TipState::Off;
+    }
+}
+
+void TipScheduler::Tick()
+{
+    m_now = timer_get_elapsed_seconds(m_clock);
+
+    auto pTip = m_pFirstActive;
+    while (pTip)
+    {
+        auto pNext = pTip->m_pNextActive;
+        pTip->Update();
+        pTip = pNext;
+    }
+}
+
+double TipScheduler::Now() const
+{
+    return m_now;
+}
+
+TipTimer* TipScheduler::GetFirstActive() const
+{
+    return m_pFirstActive;
+}
+
+size_t TipScheduler::GetActiveCount() const
+{
+    return m_activeCount;
+}
+
+bool TipScheduler::IsAnimating() const
+{
+    for (auto pTip = m_pFirstActive; pTip; pTip = pTip->m_pNextActive)
+    {
+        if (pTip->IsAnimating())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TipScheduler::Link(TipTimer* pTip)
+{
+    assert(!pTip->m_pScheduler);
+    pTip->m_pScheduler = this;
+    pTip->m_pPrevActive = nullptr;
+    pTip->m_pNextActive = m_pFirstActive;
+    if (m_pFirstActive)
+    {
+        m_pFirstActive->m_pPrevActive = pTip;
+    }
+    m_pFirstActive = pTip;
+    m_activeCount++;
+}
+
+void TipScheduler::Unlink(TipTimer* pTip)
+{
+    assert(pTip->m_pScheduler == this);
+    if (pTip->m_pPrevActive)
+    {
+        pTip->m_pPrevActive->m_pNextActive = pTip->m_pNextActive;
+    }
+    else
+    {
+        m_pFirstActive = pTip->m_pNextActive;
+    }
+    if (pTip->m_pNextActive)
+    {
+        pTip->m_pNextActive->m_pPrevActive = pTip->m_pPrevActive;
+    }
+    pTip->m_pScheduler = nullptr;
+    pTip->m_pPrevActive = nullptr;
+    pTip->m_pNextActive = nullptr;
+    m_activeCount--;
+}
+
+void TipTimer::SetState(TipState s, TipScheduler& scheduler)
+{
+    if (s == m_state)
+    {
+        return;
+    }
+    m_state = s;
+    m_decayTime = m_out;
+    m_startTime = scheduler.Now();
+
+    if (s != TipState::Off)
+    {
+        if (!m_pScheduler)
+        {
+            scheduler.Link(this);
+        }
+    }
+    else if (m_pScheduler)
+    {
+        m_pScheduler->Unlink(this);
+    }
+    Update();
+
+    if (m_pOwner)
+    {
+        m_pOwner->MarkDirty();
+    }
+}
 
 Widget::Widget(const std::string& label)
     : m_label(label), 
@@ -29,6 +149,7 @@ void Widget::SetParent(Widget* pParent)
     assert(!m_pParent);
     assert(pParent);
     m_pParent = pParent;
+    InvalidateWorldRect();
 }
 
 const NRectf& Widget::GetRect() const
@@ -41,11 +162,22 @@ void Widget::SetRect(const NRectf& sz)
     if (m_sizeHint.x == 0.0f && m_sizeHint.y == 0.0f)
     {
         m_sizeHint = sz.Size();
+        InvalidateLayout();
+    }
+    if (m_rect.topLeftPx != sz.topLeftPx || m_rect.bottomRightPx != sz.bottomRightPx)
+    {
+        m_rect = sz;
+        InvalidateWorldRect();
+        MarkDirty();
+        if (m_pParent)
+        {
+            m_pParent->ChildRectChanged(this);
+        }
     }
-    m_rect = sz;
     // LOG(DBG, "Widget: " << GetLabel() << ": " << m_rect);
 }
 
+// The parent's world rect already has all of the ancestor offsets in it, so these are O(1) once cached
 NRectf Widget::ToLocalRect(const NRectf& rc) const
 {
     if (!m_pParent)
@@ -53,9 +185,7 @@ NRectf Widget::ToLocalRect(const NRectf& rc) const
         return rc;
     }
 
-    auto rcNew = rc.Adjusted(-m_pParent->GetRect().TopLeft());
-    // return rcNew;
-    return m_pParent->ToLocalRect(rcNew);
+    return rc.Adjusted(-m_pParent->GetWorldRect().TopLeft());
 }
 
 NRectf Widget::ToWorldRect(const NRectf& rc) const
@@ -65,21 +195,56 @@ NRectf Widget::ToWorldRect(const NRectf& rc) const
         return rc;
     }
 
-    auto rcNew = rc.Adjusted(m_pParent->GetRect().TopLeft());
-    return m_pParent->ToWorldRect(rcNew);
+    return rc.Adjusted(m_pParent->GetWorldRect().TopLeft());
 }
 
 NRectf Widget::GetWorldRect() const
 {
-    return ToWorldRect(m_rect);
+    if (!m_worldRectValid)
+    {
+        m_worldRect = ToWorldRect(m_rect);
+        m_worldRectValid = true;
+    }
+    return m_worldRect;
+}
+
+void Widget::InvalidateWorldRect()
+{
+    // A valid world rect implies valid ancestors, so an invalid one already has invalid children
+    if (!m_worldRectValid)
+    {
+        return;
+    }
+    m_worldRectValid = false;
+
+    if (m_spLayout)
+    {
+        m_spLayout->InvalidateWorldRect();
+    }
+}
+
+void Widget::ChildRectChanged(Widget* pChild)
+{
+}
+
+void Widget::InvalidateLayout()
+{
+    if (m_pParent)
+    {
+        m_pParent->InvalidateLayout();
+    }
+}
+
+Layout* Widget::AsLayout()
+{
+    return nullptr;
 }
 
 void Widget::Draw(Canvas& canvas)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
 
-    if (settings.GetBool(theme, b_debugShowLayout))
+    if (theme.debugShowLayout)
     {
         canvas.FillRect(ToWorldRect(m_rect), glm::vec4(0.1f, 0.5f, 0.1f, 1.0f));
     }
@@ -94,7 +259,7 @@ void Widget::PostDraw(Canvas& canvas, const NRectf& hintRect)
 
 Widget* Widget::MouseDown(CanvasInputState& input)
 {
-    for (auto& child : GetLayout()->GetFrontToBack())
+    for (auto& child : ChildrenFrontToBack())
     {
         if (child->GetWorldRect().Contains(input.worldMousePos))
         {
@@ -109,7 +274,7 @@ Widget* Widget::MouseDown(CanvasInputState& input)
 
 void Widget::MouseUp(CanvasInputState& input)
 {
-    for (auto& child : GetLayout()->GetFrontToBack())
+    for (auto& child : ChildrenFrontToBack())
     {
         if (child->GetWorldRect().Contains(input.worldMousePos))
         {
@@ -122,7 +287,7 @@ void Widget::MouseUp(CanvasInputState& input)
 void Widget::Visit(const std::function<void(Widget*)>& fnVisit)
 {
     fnVisit(this);
-    for (auto& child : GetLayout()->GetFrontToBack())
+    for (auto& child : ChildrenFrontToBack())
     {
         child->Visit(fnVisit);
     }
@@ -130,7 +295,7 @@ void Widget::Visit(const std::function<void(Widget*)>& fnVisit)
 
 Widget* Widget::MouseHover(CanvasInputState& input)
 {
-    for (auto& child : GetLayout()->GetFrontToBack())
+    for (auto& child : ChildrenFrontToBack())
     {
         if (child->GetWorldRect().Contains(input.worldMousePos))
         {
@@ -145,7 +310,7 @@ Widget* Widget::MouseHover(CanvasInputState& input)
 
 bool Widget::MouseMove(CanvasInputState& input)
 {
-    for (auto& child : GetLayout()->GetFrontToBack())
+    for (auto& child : ChildrenFrontToBack())
     {
         if (child->GetWorldRect().Contains(input.worldMousePos))
         {
@@ -163,25 +328,21 @@ const std::string& Widget::GetLabel() const
 void Widget::SetLabel(const char* pszLabel)
 {
     m_label = pszLabel;
+    MarkDirty();
 }
 
 NRectf Widget::DrawSlab(Canvas& canvas, const NRectf& rect, float borderRadius, float shadowSize, const glm::vec4& shadowColor, float borderSize, const glm::vec4& borderColor, const glm::vec4& centerColor, const char* pszText, float fontPad, const glm::vec4& textColor, float fontSize, const char* pszFont)
 {
+    // The shadow takes its size out of the bottom right of the rect
     NRectf rc = rect;
-
-    rc.Adjust(shadowSize, shadowSize, 0.0f, 0.0f);
-    canvas.FillRoundedRect(rc, borderRadius, shadowColor);
-
-    rc.Adjust(-shadowSize, -shadowSize);
+    rc.Adjust(0.0f, 0.0f, -shadowSize, -shadowSize);
+    canvas.Slab(rc, borderRadius, shadowSize, shadowColor, borderSize, borderColor, centerColor);
 
     if (borderSize != 0.0f)
     {
-        canvas.FillRoundedRect(rc, borderRadius, borderColor);
         rc.Adjust(borderSize, borderSize, -borderSize, -borderSize);
     }
 
-    canvas.FillRoundedRect(rc, borderRadius, centerColor);
-
     if (pszText)
     {
         if (fontSize == 0.0f)
@@ -200,7 +361,11 @@ const glm::uvec2& Widget::GetConstraints() const
 
 void Widget::SetConstraints(const glm::uvec2& constraints)
 {
-    m_constraints = constraints;
+    if (m_constraints != constraints)
+    {
+        m_constraints = constraints;
+        InvalidateLayout();
+    }
 }
 
 const glm::vec4& Widget::GetPadding() const
@@ -210,13 +375,18 @@ const glm::vec4& Widget::GetPadding() const
 
 void Widget::SetPadding(const glm::vec4& padding)
 {
-    m_padding = padding;
+    if (m_padding != padding)
+    {
+        m_padding = padding;
+        InvalidateLayout();
+    }
 }
 
 void Widget::SetLayout(std::shared_ptr<Layout> spLayout)
 {
     m_spLayout = spLayout;
     m_spLayout->SetParent(this);
+    MarkDirty();
 }
 
 Layout* Widget::GetLayout()
@@ -228,6 +398,29 @@ Layout* Widget::GetLayout()
     return m_spLayout.get();
 }
 
+Layout* Widget::FindLayout()
+{
+    return m_spLayout.get();
+}
+
+std::span<const std::shared_ptr<Widget>> Widget::ChildrenFrontToBack() const
+{
+    if (!m_spLayout)
+    {
+        return {};
+    }
+    return m_spLayout->GetFrontToBack();
+}
+
+std::span<const std::shared_ptr<Widget>> Widget::ChildrenBackToFront() const
+{
+    if (!m_spLayout)
+    {
+        return {};
+    }
+    return m_spLayout->GetBackToFront();
+}
+
 uint64_t Widget::GetFlags() const
 {
     return m_flags;
@@ -235,7 +428,11 @@ uint64_t Widget::GetFlags() const
 
 void Widget::SetFlags(uint64_t flags)
 {
-    m_flags = flags;
+    if (m_flags != flags)
+    {
+        m_flags = flags;
+        InvalidateLayout();
+    }
 }
 
 glm::vec4 Widget::GetMinMaxSize() const
@@ -280,6 +477,34 @@ TipTimer& Widget::GetTipTimer()
     return m_tipTimer;
 }
 
+void Widget::MarkDirty()
+{
+    m_dirty = true;
+    if (m_pParent)
+    {
+        m_pParent->MarkDirty();
+    }
+}
+
+bool Widget::IsDirty() const
+{
+    return m_dirty;
+}
+
+void Widget::ClearDirty()
+{
+    m_dirty = false;
+}
+
+DrawList& Widget::GetDrawCache()
+{
+    if (!m_spDrawCache)
+    {
+        m_spDrawCache = std::make_shared<DrawList>();
+    }
+    return *m_spDrawCache;
+}
+
 bool Widget::IsMouseHover(Canvas& canvas)
 {
     auto state = m_tipTimer.GetState();
@@ -313,7 +538,7 @@ bool Widget::IsMouseOver(Canvas& canvas)
         return true;
     }
 
-    for (auto& child : GetLayout()->GetFrontToBack())
+    for (auto& child : ChildrenFrontToBack())
     {
         if (child->GetWorldRect().Contains(state.worldMousePos))
         {
@@ -341,13 +566,13 @@ void Widget::DrawTip(Canvas& canvas, const glm::vec2& widgetTopCenter, const Wid
             return;
         }
         //std::string tip = fmt::format("{}: {} {}", val.name, val.value, val.units);
-        std::string tip = std::format("{} {}", val.valueText, val.units);
+        std::pmr::string tip(&canvas.GetFrameArena());
+        std::format_to(std::back_inserter(tip), "{} {}", val.valueText, val.units);
 
-        auto& settings = Zest::GlobalSettingsManager::Instance();
-        auto theme = settings.GetCurrentTheme();
+        auto& theme = canvas.GetTheme();
 
-        auto tipPad = settings.GetFloat(theme, s_sliderTipFontPad);
-        auto fontSize = settings.GetFloat(theme, s_sliderTipFontSize);
+        auto tipPad = theme.sliderTipFontPad;
+        auto fontSize = theme.sliderTipFontSize;
 
         auto rcBounds = canvas.TextBounds(widgetTopCenter, fontSize, tip.c_str(), nullptr, TEXT_ALIGN_TOP | TEXT_ALIGN_LEFT);
         rcBounds.SetHeight(fontSize);
@@ -358,15 +583,15 @@ void Widget::DrawTip(Canvas& canvas, const glm::vec2& widgetTopCenter, const Wid
 
         auto rc = DrawSlab(canvas,
             panelRect,
-            settings.GetFloat(theme, s_sliderTipBorderRadius),
-            settings.GetFloat(theme, s_sliderTipShadowSize),
-            Zest::ModifyAlpha(settings.GetVec4f(theme, c_sliderTipShadowColor), alpha),
-            settings.GetFloat(theme, s_sliderTipBorderSize),
-            Zest::ModifyAlpha(settings.GetVec4f(theme, c_sliderTipBorderColor), alpha),
-            Zest::ModifyAlpha(settings.GetVec4f(theme, c_sliderTipCenterColor), alpha),
+            theme.sliderTipBorderRadius,
+            theme.sliderTipShadowSize,
+            Zest::ModifyAlpha(theme.sliderTipShadowColor, alpha),
+            theme.sliderTipBorderSize,
+            Zest::ModifyAlpha(theme.sliderTipBorderColor, alpha),
+            Zest::ModifyAlpha(theme.sliderTipCenterColor, alpha),
             tip.c_str(),
             4.0f,
-            Zest::ModifyAlpha(TextColorForBackground(settings.GetVec4f(theme, c_sliderTipCenterColor)), alpha),
+            Zest::ModifyAlpha(TextColorForBackground(theme.sliderTipCenterColor), alpha),
             fontSize);
     }
 }
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <format>
+#include <iterator>
 
 #include <zest/logger/logger.h>
 
@@ -20,13 +21,12 @@ Knob::Knob(const std::string& label, IKnobCB* pCB)
 
 void Knob::Draw(Canvas& canvas)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
     Widget::Draw(canvas);
 
     auto rc = GetWorldRect();
 
-    if (settings.GetBool(theme, b_debugShowLayout))
+    if (theme.debugShowLayout)
     {
         DrawSlab(canvas,
             rc,
@@ -48,8 +48,8 @@ void Knob::Draw(Canvas& canvas)
         UpdateKnob(this, KnobOp::Get, val);
     }
 
-    auto textSize = settings.GetFloat(theme, s_knobTextSize);
-    auto pack = settings.GetFloat(theme, s_knobTextInset);
+    auto textSize = theme.knobTextSize;
+    auto pack = theme.knobTextInset;
 
     NRectf remain = rc.Adjusted(glm::vec4(0.0f, 0.0f, 0.0f, -(textSize - pack)));
     NRectf textRect = rc.Adjusted(glm::vec4(0.0f, rc.Height() - textSize, 0.0f, -pack));
@@ -76,26 +76,26 @@ void Knob::Draw(Canvas& canvas)
     float ratioOrigin = 0.0f;
     auto posArcBegin = startArc + arcRange * ratioOrigin;
 
-    auto channelWidth = settings.GetFloat(theme, s_knobChannelWidth);
-    auto channelGap = settings.GetFloat(theme, s_knobChannelGap);
+    auto channelWidth = theme.knobChannelWidth;
+    auto channelGap = theme.knobChannelGap;
 
     auto innerSize = knobSize - channelWidth - channelGap;
 
-    auto shadowColor = settings.GetVec4f(theme, c_knobShadowColor);
+    auto shadowColor = theme.knobShadowColor;
 
     // Knob surrounding shadow; a filled circle behind it
     canvas.FilledCircle(knobRegion.Center(), innerSize, shadowColor);
 
-    innerSize -= settings.GetFloat(theme, s_knobShadowSize);
+    innerSize -= theme.knobShadowSize;
 
-    auto color = settings.GetVec4f(theme, c_knobFillColor);
-    auto colorHL = settings.GetVec4f(theme, c_knobFillHLColor);
-    auto markColor = settings.GetVec4f(theme, c_knobMarkColor);
-    auto markHLColor = settings.GetVec4f(theme, c_knobMarkHLColor);
-    auto channelHLColor = settings.GetVec4f(theme, c_knobChannelHLColor);
-    auto channelColor = settings.GetVec4f(theme, c_knobChannelColor);
+    auto color = theme.knobFillColor;
+    auto colorHL = theme.knobFillHLColor;
+    auto markColor = theme.knobMarkColor;
+    auto markHLColor = theme.knobMarkHLColor;
+    auto channelHLColor = theme.knobChannelHLColor;
+    auto channelColor = theme.knobChannelColor;
     
-    auto shadowSize = settings.GetFloat(theme, s_knobShadowSize);
+    auto shadowSize = theme.knobShadowSize;
 
     if (val.flags & KnobFlags::ReadOnly)
     {
@@ -139,7 +139,7 @@ void Knob::Draw(Canvas& canvas)
 
     canvas.Arc(knobRegion.Center(), knobSize - channelWidth * .5f, channelWidth, channelHLColor, posArcBegin + arcOffset, posArc + arcOffset);
 
-    canvas.Text(textRect.Center(), textSize, TextColorForBackground(settings.GetVec4f(theme, c_knobFillColor)), val.name.c_str(), nullptr, TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER);
+    canvas.Text(textRect.Center(), textSize, TextColorForBackground(theme.knobFillColor), val.name.c_str(), nullptr, TEXT_ALIGN_MIDDLE | TEXT_ALIGN_CENTER);
     //canvas.Text()
     /*
     if (fCurrentVal > (fMax + std::numeric_limits<float>::epsilon()))
@@ -154,7 +154,7 @@ void Knob::Draw(Canvas& canvas)
 
     DrawTip(canvas, glm::vec2(knobRegion.Center().x, knobRegion.Top()), val);
 
-    for (auto& child : GetLayout()->GetBackToFront())
+    for (auto& child : ChildrenBackToFront())
     {
         child->Draw(canvas);
     }
@@ -216,6 +216,7 @@ void Knob::Update(CanvasInputState& input)
     {
         UpdateKnob(this, KnobOp::Set, val);
     }
+    MarkDirty();
 }
 
 bool Knob::MouseMove(CanvasInputState& input)
@@ -237,7 +238,9 @@ void Knob::UpdateKnob(Knob* pKnob, KnobOp op, KnobValue& val)
     }
     else
     {
-        m_value.valueText = std::format("{:1.2f}", m_value.value);
+        // Formatted into the existing string, which keeps its capacity
+        m_value.valueText.clear();
+        std::format_to(std::back_inserter(m_value.valueText), "{:1.2f}", m_value.value);
         val = m_value;
     }
 }
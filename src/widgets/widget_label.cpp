@@ -17,8 +17,7 @@ TextLabel::TextLabel(const std::string& label, const std::string& font)
 
 void TextLabel::Draw(Canvas& canvas)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
 
     Widget::Draw(canvas);
 
@@ -27,19 +26,19 @@ void TextLabel::Draw(Canvas& canvas)
     // Draw the background area
     rc = DrawSlab(canvas,
         rc,
-        settings.GetFloat(theme, s_sliderBorderRadius),
-        settings.GetFloat(theme, s_sliderShadowSize),
-        settings.GetVec4f(theme, c_sliderShadowColor),
-        settings.GetFloat(theme, s_sliderBorderSize),
-        settings.GetVec4f(theme, c_sliderBorderColor),
-        settings.GetVec4f(theme, c_sliderCenterColor),
+        theme.sliderBorderRadius,
+        theme.sliderShadowSize,
+        theme.sliderShadowColor,
+        theme.sliderBorderSize,
+        theme.sliderBorderColor,
+        theme.sliderCenterColor,
         m_label.c_str(),
         2.0f,
         glm::vec4(1.0f), 
         0.0f,
         m_font.empty() ? nullptr : m_font.c_str());
 
-    for (auto& child : GetLayout()->GetBackToFront())
+    for (auto& child : ChildrenBackToFront())
     {
         child->Draw(canvas);
     }
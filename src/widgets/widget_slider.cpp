@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <format>
+#include <iterator>
 
 #include <zest/logger/logger.h>
 
@@ -26,7 +27,9 @@ void DefaultSliderCB::UpdateSlider(Slider* pSlider, SliderOp op, SliderValue& va
     if (op == SliderOp::Get)
     {
         myVal.name = pSlider->GetLabel();
-        myVal.valueText = std::format("{:1.2f}", myVal.value);
+        // Formatted into the existing string, which keeps its capacity
+        myVal.valueText.clear();
+        std::format_to(std::back_inserter(myVal.valueText), "{:1.2f}", myVal.value);
         val = myVal;
     }
     else
@@ -54,10 +57,9 @@ Slider::Slider(const std::string& label, std::shared_ptr<ISliderCB> pCB)
 
 float Slider::ThumbWorldSize(Canvas& canvas, float width) const
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
 
-    auto thumbPad = settings.GetFloat(theme, s_sliderThumbPad);
+    auto thumbPad = theme.sliderThumbPad;
     width = std::max(width, 4.0f);
     auto pixelSize = canvas.WorldSizeToPixelSize(std::max(1.0f, width));
     if (pixelSize < 4.0f)
@@ -69,25 +71,24 @@ float Slider::ThumbWorldSize(Canvas& canvas, float width) const
 
 void Slider::Draw(Canvas& canvas)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
 
     auto rc = GetWorldRect();
 
     // Draw the background area
     rc = DrawSlab(canvas,
         rc,
-        settings.GetFloat(theme, s_sliderBorderRadius),
-        settings.GetFloat(theme, s_sliderShadowSize),
-        settings.GetVec4f(theme, c_sliderShadowColor),
-        settings.GetFloat(theme, s_sliderBorderSize),
-        settings.GetVec4f(theme, c_sliderBorderColor),
-        settings.GetVec4f(theme, c_sliderCenterColor));
+        theme.sliderBorderRadius,
+        theme.sliderShadowSize,
+        theme.sliderShadowColor,
+        theme.sliderBorderSize,
+        theme.sliderBorderColor,
+        theme.sliderCenterColor);
 
     // canvas.FillRect(rc, glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
 
-    auto thumbPad = settings.GetFloat(theme, s_sliderThumbPad);
-    auto fontSize = rc.Height() - settings.GetFloat(theme, s_sliderFontPad) * 2.0f - thumbPad * 2.0f;
+    auto thumbPad = theme.sliderThumbPad;
+    auto fontSize = rc.Height() - theme.sliderFontPad * 2.0f - thumbPad * 2.0f;
     auto titlePanelRect = rc;
 
     // Our inside track is inside the thumb pad
@@ -117,21 +118,21 @@ void Slider::Draw(Canvas& canvas)
 
     DrawSlab(canvas,
         thumbRect,
-        settings.GetFloat(theme, s_sliderThumbRadius),
-        settings.GetFloat(theme, s_sliderThumbShadowSize),
-        settings.GetVec4f(theme, c_sliderThumbShadowColor),
+        theme.sliderThumbRadius,
+        theme.sliderThumbShadowSize,
+        theme.sliderThumbShadowColor,
         0.0f,
         glm::vec4(0.0f),
-        settings.GetVec4f(theme, c_sliderThumbColor));
+        theme.sliderThumbColor);
 
     if (val.valueFlags & WidgetValueFlags::ShowText)
     {
-        canvas.Text(glm::vec2(titlePanelRect.Left(), titlePanelRect.Center().y), fontSize, TextColorForBackground(settings.GetVec4f(theme, c_sliderCenterColor)), val.name.c_str(), nullptr, TEXT_ALIGN_MIDDLE | TEXT_ALIGN_LEFT);
+        canvas.Text(glm::vec2(titlePanelRect.Left(), titlePanelRect.Center().y), fontSize, TextColorForBackground(theme.sliderCenterColor), val.name.c_str(), nullptr, TEXT_ALIGN_MIDDLE | TEXT_ALIGN_LEFT);
 
         DrawTip(canvas, glm::vec2(titlePanelRect.Center().x, titlePanelRect.Top()), val);
     }
 
-    for (auto& child : GetLayout()->GetBackToFront())
+    for (auto& child : ChildrenBackToFront())
     {
         child->Draw(canvas);
     }
@@ -181,6 +182,7 @@ void Slider::Update(CanvasInputState& input)
     ClampNormalized(val);
 
     m_pCB->UpdateSlider(this, SliderOp::Set, val);
+    MarkDirty();
 }
 
 bool Slider::MouseMove(CanvasInputState& input)
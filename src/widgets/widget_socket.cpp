@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <format>
+#include <iterator>
 #include <zest/logger/logger.h>
 #include <nodegraph/canvas.h>
 #include <nodegraph/theme.h>
@@ -22,8 +23,7 @@ Socket::Socket(const std::string& label, SocketType type, ISocketCB* pCB)
 
 void Socket::Draw(Canvas& canvas)
 {
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
 
     Widget::Draw(canvas);
 
@@ -55,7 +55,7 @@ void Socket::Draw(Canvas& canvas)
         canvas.DrawLine(start, end, glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), socketRadius);
     }
 
-    auto color = settings.GetVec4f(theme, c_socketColor);
+    auto color = theme.socketColor;
 
     if (val.flags & SocketFlags::ReadOnly)
     {
@@ -69,7 +69,7 @@ void Socket::Draw(Canvas& canvas)
     }
     */
 
-    for (auto& child : GetLayout()->GetBackToFront())
+    for (auto& child : ChildrenBackToFront())
     {
         child->Draw(canvas);
     }
@@ -106,6 +106,7 @@ void Socket::Update(CanvasInputState& input)
     ClampNormalized(val);
 
     m_pCB->UpdateSocket(this, SocketOp::Set, val);
+    MarkDirty();
 }
 
 bool Socket::MouseMove(CanvasInputState& input)
@@ -127,7 +128,9 @@ void Socket::UpdateSocket(Socket* pSocket, SocketOp op, SocketValue& val)
     }
     else
     {
-        m_value.valueText = std::format("{:1.2f}", m_value.value);
+        // Formatted into the existing string, which keeps its capacity
+        m_value.valueText.clear();
+        std::format_to(std::back_inserter(m_value.valueText), "{:1.2f}", m_value.value);
         val = m_value;
     }
 }
@@ -36,7 +36,7 @@ void TextLabel::Draw(Canvas& canvas)
         0.0f,
         m_font.empty() ? nullptr : m_font.c_str());
 
-    for (auto& child : GetLayout()->GetBackToFront())
+    for (auto& child : ChildrenBackToFront())
     {
         child->Draw(canvas);
     }
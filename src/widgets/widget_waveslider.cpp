@@ -53,15 +53,14 @@ void WaveSlider::PostDraw(Canvas& canvas, const NRectf& rc)
             float width;
             glm::vec4 color;
 
-            auto& settings = Zest::GlobalSettingsManager::Instance();
-            auto theme = settings.GetCurrentTheme();
-            auto thumbColor = settings.GetVec4f(theme, c_waveSliderCenterColor);
+            auto& theme = canvas.GetTheme();
+            auto thumbColor = theme.waveSliderCenterColor;
             auto waveColor = glm::vec4(thumbColor.x * colorScale, thumbColor.y * colorScale, thumbColor.z * colorScale, 1.0f);
             // Shadow
             if (y == 0)
             {
                 width = 7.0f;
-                color = settings.GetVec4f(theme, c_waveSliderBorderColor);
+                color = theme.waveSliderBorderColor;
                 // color = Zest::ColorForBackground(waveColor);
             }
             else
@@ -70,76 +69,82 @@ void WaveSlider::PostDraw(Canvas& canvas, const NRectf& rc)
                 color = waveColor;
             }
 
+            auto left = waveRect.Left();
+            auto span = waveRect.Width();
             if (waveType == WaveType::Triangle)
             {
                 waveRect.Adjust(0.0f, 0.0f, 0.0f, -4.0f);
-                auto start = glm::vec2(waveRect.Left(), waveRect.Center().y);
-                auto end = glm::vec2(waveRect.Right(), waveRect.Center().y);
-                canvas.FilledCircle(start, width * .5f, color);
-                canvas.BeginStroke(start, width, color);
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .25f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .5f, waveRect.Bottom()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .75f, waveRect.Top()));
-                canvas.LineTo(end);
-                canvas.EndStroke();
-                canvas.FilledCircle(end, width * .5f, color);
+                m_wavePoints = {
+                    glm::vec2(left, waveRect.Center().y),
+                    glm::vec2(left + span * .25f, waveRect.Top()),
+                    glm::vec2(left + span * .5f, waveRect.Bottom()),
+                    glm::vec2(left + span * .75f, waveRect.Top()),
+                    glm::vec2(waveRect.Right(), waveRect.Center().y)
+                };
             }
             else if (waveType == WaveType::Square)
             {
-                auto start = glm::vec2(waveRect.Left(), waveRect.Center().y);
-                auto end = glm::vec2(waveRect.Left() + waveRect.Width(), waveRect.Center().y);
-                canvas.FilledCircle(start, width * .5f, color);
-                canvas.BeginStroke(start, width, color);
-                canvas.LineTo(glm::vec2(waveRect.Left(), waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .33f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .33f, waveRect.Bottom()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .66f, waveRect.Bottom()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .66f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width(), waveRect.Top()));
-                canvas.LineTo(end);
-                canvas.EndStroke();
-                canvas.FilledCircle(end, width * .5f, color);
+                m_wavePoints = {
+                    glm::vec2(left, waveRect.Center().y),
+                    glm::vec2(left, waveRect.Top()),
+                    glm::vec2(left + span * .33f, waveRect.Top()),
+                    glm::vec2(left + span * .33f, waveRect.Bottom()),
+                    glm::vec2(left + span * .66f, waveRect.Bottom()),
+                    glm::vec2(left + span * .66f, waveRect.Top()),
+                    glm::vec2(left + span, waveRect.Top()),
+                    glm::vec2(left + span, waveRect.Center().y)
+                };
             }
             else if (waveType == WaveType::PWM)
             {
-                auto start = glm::vec2(waveRect.Left() + waveRect.Width() * .1f, waveRect.Center().y);
-                auto end = glm::vec2(waveRect.Left() + waveRect.Width() * .8f, waveRect.Center().y);
-                canvas.FilledCircle(start, width * .5f, color);
-                canvas.BeginStroke(start, width, color);
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .1f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .3f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .3f, waveRect.Bottom()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .6f, waveRect.Bottom()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .6f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .8f, waveRect.Top()));
-                canvas.LineTo(end);
-                canvas.EndStroke();
-                canvas.FilledCircle(end, width * .5f, color);
+                m_wavePoints = {
+                    glm::vec2(left + span * .1f, waveRect.Center().y),
+                    glm::vec2(left + span * .1f, waveRect.Top()),
+                    glm::vec2(left + span * .3f, waveRect.Top()),
+                    glm::vec2(left + span * .3f, waveRect.Bottom()),
+                    glm::vec2(left + span * .6f, waveRect.Bottom()),
+                    glm::vec2(left + span * .6f, waveRect.Top()),
+                    glm::vec2(left + span * .8f, waveRect.Top()),
+                    glm::vec2(left + span * .8f, waveRect.Center().y)
+                };
             }
             else if (waveType == WaveType::Saw)
             {
                 waveRect.Adjust(0.0f, 0.0f, 0.0f, -4.0f);
-
-                auto start = glm::vec2(waveRect.Left(), waveRect.Center().y);
-                auto end = glm::vec2(waveRect.Left() + waveRect.Width(), waveRect.Center().y);
-                canvas.FilledCircle(start, width * .5f, color);
-                canvas.BeginStroke(start, width, color);
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .25f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .25f, waveRect.Bottom()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .75f, waveRect.Top()));
-                canvas.LineTo(glm::vec2(waveRect.Left() + waveRect.Width() * .75f, waveRect.Bottom()));
-                canvas.LineTo(end);
-                canvas.EndStroke();
-                canvas.FilledCircle(end, width * .5f, color);
+                m_wavePoints = {
+                    glm::vec2(left, waveRect.Center().y),
+                    glm::vec2(left + span * .25f, waveRect.Top()),
+                    glm::vec2(left + span * .25f, waveRect.Bottom()),
+                    glm::vec2(left + span * .75f, waveRect.Top()),
+                    glm::vec2(left + span * .75f, waveRect.Bottom()),
+                    glm::vec2(left + span, waveRect.Center().y)
+                };
             }
+
+            // Round the ends off, with the whole shape as one line between them
+            canvas.FilledCircle(m_wavePoints.front(), width * .5f, color);
+            canvas.Polyline(m_wavePoints, width, color);
+            canvas.FilledCircle(m_wavePoints.back(), width * .5f, color);
         }
     }
     canvas.SetLineCap(LineCap::BUTT);
 }
 
-void WaveSlider::SetWave(const std::vector<float>& vals)
+void WaveSlider::SetWave(std::span<const float> vals)
+{
+    m_waveform.Set(vals);
+    MarkDirty();
+}
+
+void WaveSlider::AppendWave(std::span<const float> vals)
 {
-    m_wave = vals;
+    m_waveform.Append(vals);
+    MarkDirty();
+}
+
+const Waveform& WaveSlider::GetWaveform() const
+{
+    return m_waveform;
 }
 
 void WaveSlider::DrawGeneratedWave(Canvas& canvas, const NRectf& rc)
@@ -155,45 +160,68 @@ void WaveSlider::DrawGeneratedWave(Canvas& canvas, const NRectf& rc)
 
     auto rcWorld = ToWorldRect(rc);
 
-    auto& settings = Zest::GlobalSettingsManager::Instance();
-    auto theme = settings.GetCurrentTheme();
+    auto& theme = canvas.GetTheme();
 
     // Draw the background area
     rcWorld = DrawSlab(canvas,
         rcWorld,
-        settings.GetFloat(theme, s_sliderBorderRadius),
-        settings.GetFloat(theme, s_sliderShadowSize),
-        settings.GetVec4f(theme, c_sliderShadowColor),
-        settings.GetFloat(theme, s_sliderBorderSize),
-        settings.GetVec4f(theme, c_sliderBorderColor),
-        settings.GetVec4f(theme, c_sliderCenterColor));
+        theme.sliderBorderRadius,
+        theme.sliderShadowSize,
+        theme.sliderShadowColor,
+        theme.sliderBorderSize,
+        theme.sliderBorderColor,
+        theme.sliderCenterColor);
 
-    auto waveColor = settings.GetVec4f(theme, c_sliderThumbColor);
+    auto waveColor = theme.sliderThumbColor;
 
-    if (m_wave.empty())
+    if (m_waveform.Empty())
     {
         return;
     }
 
     rcWorld.Adjust(8, 8, -8, -8);
-    for (uint32_t x = 0; x < rcWorld.Width(); x++)
+
+    // A column per pixel, summarized from whichever level of the pyramid is nearest
+    auto columns = uint32_t(std::max(canvas.WorldSizeToPixelSize(rcWorld.Width()), 1.0f));
+    m_waveform.Summarize(0, m_waveform.GetSampleCount(), columns, m_waveBins);
+
+    auto step = rcWorld.Width() / float(columns);
+    auto centerY = rcWorld.Center().y;
+    auto scaleY = rcWorld.Height() * 0.5f;
+
+    m_wavePoints.clear();
+    if (m_waveform.GetSampleCount() <= columns)
     {
-        auto index = size_t(x * m_wave.size() / rc.Width());
-        if (index >= m_wave.size())
-        {
-            continue;
-        }
-        auto y = m_wave[index];
-        if (x == 0)
+        // No more samples than pixels, so just the samples as a line
+        for (uint32_t column = 0; column < columns; column++)
         {
-            canvas.BeginStroke(glm::vec2(rcWorld.Left(), rcWorld.Center().y + y * rcWorld.Height() * 0.5f), 4.0f, waveColor);
+            m_wavePoints.push_back(glm::vec2(rcWorld.Left() + column * step, centerY + m_waveBins[column].maximum * scaleY));
         }
-        else
+        canvas.Polyline(m_wavePoints, 4.0f, waveColor);
+        return;
+    }
+
+    // Zig-zag between each column's min and max; at one column per pixel that fills in the envelope
+    for (uint32_t column = 0; column < columns; column++)
+    {
+        auto x = rcWorld.Left() + column * step;
+        m_wavePoints.push_back(glm::vec2(x, centerY + m_waveBins[column].minimum * scaleY));
+        m_wavePoints.push_back(glm::vec2(x, centerY + m_waveBins[column].maximum * scaleY));
+    }
+    canvas.Polyline(m_wavePoints, 4.0f, waveColor);
+
+    // The RMS band inside it, once each column covers enough samples for it to mean something
+    if (m_waveform.GetSampleCount() >= size_t(columns) * Waveform::BinSamples)
+    {
+        m_wavePoints.clear();
+        for (uint32_t column = 0; column < columns; column++)
         {
-            canvas.LineTo(glm::vec2(rcWorld.Left() + x, rcWorld.Center().y + y * rcWorld.Height() * 0.5f));
+            auto x = rcWorld.Left() + column * step;
+            m_wavePoints.push_back(glm::vec2(x, centerY - m_waveBins[column].rms * scaleY));
+            m_wavePoints.push_back(glm::vec2(x, centerY + m_waveBins[column].rms * scaleY));
         }
+        canvas.Polyline(m_wavePoints, 1.0f, glm::vec4(glm::vec3(waveColor.x, waveColor.y, waveColor.z) * 0.6f, waveColor.w));
     }
-    canvas.EndStroke();
 }
 
 } // Nodegraph
@@ -0,0 +1,107 @@
+#include <algorithm>
+
+#include <nodegraph/worker_pool.h>
+
+namespace NodeGraph {
+
+WorkerPool::WorkerPool(uint32_t workerCount)
+{
+    // Worker 0 is whoever calls Run
+    for (uint32_t worker = 1; worker < std::max(workerCount, 1u); worker++)
+    {
+        m_threads.emplace_back(&WorkerPool::ThreadMain, this, worker);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+uint32_t WorkerPool::GetWorkerCount() const
+{
+    return uint32_t(m_threads.size()) + 1;
+}
+
+void WorkerPool::Run(size_t count, const std::function<void(size_t, uint32_t)>& fn)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (m_threads.empty())
+    {
+        for (size_t item = 0; item < count; item++)
+        {
+            fn(item, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pFn = &fn;
+        m_count = count;
+        m_next = 0;
+        m_running = uint32_t(m_threads.size());
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    Work(0);
+
+    // Every thread takes part in every run, so none can still be on this one when the next starts
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [&]() { return m_running == 0; });
+    m_pFn = nullptr;
+}
+
+void WorkerPool::ThreadMain(uint32_t worker)
+{
+    uint64_t generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_quit || m_generation != generation; });
+            if (m_quit)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        Work(worker);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_running == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
+
+void WorkerPool::Work(uint32_t worker)
+{
+    for (;;)
+    {
+        auto item = m_next.fetch_add(1);
+        if (item >= m_count)
+        {
+            return;
+        }
+        (*m_pFn)(item, worker);
+    }
+}
+
+} // namespace NodeGraph
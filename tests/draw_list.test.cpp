@@ -0,0 +1,195 @@
+#include <cstddef>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include <nodegraph/canvas_null.h>
+#include <nodegraph/draw_list.h>
+
+#include "catch.hpp"
+
+using namespace NodeGraph;
+
+namespace {
+
+// One of every command, all inside the default view
+void record_everything(DrawList& drawList)
+{
+    auto rc = NRectf(10.0f, 10.0f, 100.0f, 50.0f);
+    auto color = glm::vec4(1.0f, 0.5f, 0.25f, 1.0f);
+    glm::vec2 points[] = { glm::vec2(10.0f, 10.0f), glm::vec2(50.0f, 80.0f), glm::vec2(90.0f, 10.0f) };
+
+    drawList.FilledCircle(glm::vec2(20.0f), 5.0f, color);
+    drawList.FilledGradientCircle(glm::vec2(20.0f), 5.0f, rc, color, color);
+    drawList.FillRoundedRect(rc, 4.0f, color);
+    drawList.FillRect(rc, color);
+    drawList.FillGradientRoundedRect(rc, 4.0f, rc, color, color);
+    drawList.FillGradientRoundedRectVarying(rc, glm::vec4(4.0f), rc, color, color);
+    drawList.Stroke(glm::vec2(0.0f), glm::vec2(100.0f), 2.0f, color);
+    drawList.Arc(glm::vec2(50.0f), 10.0f, 2.0f, color, 0.0f, 90.0f);
+    drawList.SetAA(true);
+    drawList.BeginStroke(glm::vec2(0.0f), 2.0f, color);
+    drawList.BeginPath(glm::vec2(0.0f), color);
+    drawList.MoveTo(glm::vec2(10.0f));
+    drawList.LineTo(glm::vec2(20.0f));
+    drawList.SetLineCap(LineCap::ROUND);
+    drawList.ClosePath();
+    drawList.EndPath();
+    drawList.EndStroke();
+    drawList.Polyline(points, 2.0f, color, false);
+    drawList.Text(glm::vec2(20.0f), 12.0f, color, "Node", "sans", TEXT_ALIGN_LEFT);
+    drawList.TextBox(glm::vec2(20.0f), 12.0f, 80.0f, color, "Some longer text", nullptr, TEXT_ALIGN_LEFT);
+    drawList.Slab(rc, 4.0f, 2.0f, color, 1.0f, color, color);
+    drawList.FillConvexPolygon(points, color);
+
+    PolylineRun runs[2];
+    runs[0].count = 2;
+    runs[0].color = color;
+    runs[1].offset = 1;
+    runs[1].count = 2;
+    runs[1].color = color;
+    drawList.Polylines(points, runs);
+
+    CableDesc cables[2];
+    cables[0].from = glm::vec2(10.0f, 10.0f);
+    cables[0].fromTangent = glm::vec2(50.0f, 0.0f);
+    cables[0].to = glm::vec2(200.0f, 100.0f);
+    cables[0].toTangent = glm::vec2(-50.0f, 0.0f);
+    cables[1] = cables[0];
+    cables[1].to = glm::vec2(300.0f, 200.0f);
+    drawList.Cables(cables);
+}
+
+CanvasNullCounters replay(const DrawList& drawList)
+{
+    CanvasNull canvas;
+    canvas.Begin(glm::vec4(0.0f));
+    drawList.Replay(canvas);
+    canvas.End();
+    return canvas.GetCounters();
+}
+
+std::string write(const DrawList& drawList)
+{
+    std::stringstream stream;
+    drawList.Write(stream);
+    return stream.str();
+}
+
+bool read(DrawList& drawList, const std::string& data)
+{
+    std::stringstream stream(data);
+    return drawList.Read(stream);
+}
+
+} // namespace
+
+TEST_CASE("DrawList replays the same calls after a write and read", "[DrawList]")
+{
+    DrawList original;
+    record_everything(original);
+
+    DrawList loaded;
+    REQUIRE(read(loaded, write(original)));
+    REQUIRE(loaded.Size() == original.Size());
+
+    auto expected = replay(original);
+    auto actual = replay(loaded);
+    REQUIRE(actual.calls == expected.calls);
+    REQUIRE(actual.polylinePoints == expected.polylinePoints);
+    REQUIRE(actual.polylineBatches == expected.polylineBatches);
+    REQUIRE(actual.textBytes == expected.textBytes);
+
+    // Every single command reaches the backend once; the batch and the cables stay batches
+    for (auto type : { DrawCmdType::FilledCircle, DrawCmdType::FillRect, DrawCmdType::Arc, DrawCmdType::FillConvexPolygon, DrawCmdType::Text, DrawCmdType::TextBox, DrawCmdType::Slab })
+    {
+        REQUIRE(actual.calls[size_t(type)] == 1);
+    }
+    REQUIRE(actual.polylineBatches == 2);
+    REQUIRE(actual.calls[size_t(DrawCmdType::Polyline)] == 5);
+    REQUIRE(actual.textBytes == strlen("Node") + strlen("Some longer text"));
+}
+
+TEST_CASE("DrawList rejects a truncated trace", "[DrawList]")
+{
+    DrawList original;
+    record_everything(original);
+    auto data = write(original);
+
+    // Wherever the stream is cut, the list must not read back
+    DrawList loaded;
+    for (size_t length = 0; length < data.size(); length++)
+    {
+        INFO("Length " << length);
+        REQUIRE_FALSE(read(loaded, data.substr(0, length)));
+        REQUIRE(loaded.Empty());
+    }
+
+    // The same with only the argument data cut short, so that the stream itself is still well formed
+    auto dataStart = sizeof(uint32_t) + original.Size() * sizeof(DrawCmd);
+    uint32_t floatCount = 0;
+    memcpy(&floatCount, &data[dataStart], sizeof(floatCount));
+    auto textStart = dataStart + sizeof(uint32_t) + floatCount * sizeof(float);
+    for (uint32_t count = 0; count < floatCount; count++)
+    {
+        INFO("Floats " << count);
+        auto cut = data.substr(0, dataStart);
+        cut.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        cut.append(data, dataStart + sizeof(uint32_t), count * sizeof(float));
+        cut.append(data, textStart);
+        REQUIRE_FALSE(read(loaded, cut));
+    }
+}
+
+TEST_CASE("DrawList rejects counts that run past the data", "[DrawList]")
+{
+    glm::vec2 points[] = { glm::vec2(0.0f), glm::vec2(10.0f), glm::vec2(20.0f) };
+
+    // Layout of a one command list; the command array, then the data array with the point count after the width and color
+    DrawList drawList;
+    drawList.Polyline(points, 1.0f, glm::vec4(1.0f), false);
+    auto data = write(drawList);
+    auto countOffset = sizeof(uint32_t) + sizeof(DrawCmd) + sizeof(uint32_t) + 5 * sizeof(float);
+
+    SECTION("Point count")
+    {
+        float count = 4.0f;
+        memcpy(&data[countOffset], &count, sizeof(count));
+        REQUIRE_FALSE(read(drawList, data));
+    }
+
+    SECTION("Array size")
+    {
+        uint32_t size = 0x7FFFFFFF;
+        memcpy(&data[0], &size, sizeof(size));
+        REQUIRE_FALSE(read(drawList, data));
+    }
+
+    SECTION("Untouched")
+    {
+        REQUIRE(read(drawList, data));
+    }
+}
+
+TEST_CASE("DrawList rejects a line cap the backends don't know", "[DrawList]")
+{
+    DrawList drawList;
+    drawList.SetLineCap(LineCap::BUTT);
+    auto data = write(drawList);
+
+    // The cap is in the flags of the only command, just after the command count
+    auto flagsOffset = sizeof(uint32_t) + offsetof(DrawCmd, flags);
+
+    SECTION("Out of range")
+    {
+        uint32_t cap = 2;
+        memcpy(&data[flagsOffset], &cap, sizeof(cap));
+        REQUIRE_FALSE(read(drawList, data));
+        REQUIRE(drawList.Empty());
+    }
+
+    SECTION("Untouched")
+    {
+        REQUIRE(read(drawList, data));
+    }
+}
@@ -0,0 +1,176 @@
+#include <sstream>
+#include <vector>
+
+#include <nodegraph/node_store.h>
+
+#include "catch.hpp"
+
+using namespace NodeGraph;
+
+namespace {
+
+std::vector<NodeHandle> handles_in_draw_order(NodeStore& store)
+{
+    std::vector<NodeHandle> handles;
+    for (auto slot : store.GetPreOrder())
+    {
+        handles.push_back(store.HandleAt(slot));
+    }
+    return handles;
+}
+
+} // namespace
+
+TEST_CASE("NodeStore handles go stale when their slot is reused", "[NodeStore]")
+{
+    NodeStore store;
+    auto first = store.Add(NRectf(0.0f, 0.0f, 10.0f, 10.0f));
+    auto child = store.Add(NRectf(1.0f, 1.0f, 2.0f, 2.0f), first);
+    REQUIRE(store.Size() == 2);
+    REQUIRE(store.GetParent(child) == first);
+
+    // Removing a node takes its children with it
+    store.Remove(first);
+    REQUIRE(store.Size() == 0);
+    REQUIRE_FALSE(store.IsValid(first));
+    REQUIRE_FALSE(store.IsValid(child));
+
+    // The slots are reused, but the old handles still don't resolve to the new nodes
+    auto second = store.Add(NRectf(5.0f, 5.0f, 10.0f, 10.0f));
+    auto third = store.Add(NRectf(6.0f, 6.0f, 10.0f, 10.0f));
+    REQUIRE((second.index == first.index || second.index == child.index));
+    REQUIRE((third.index == first.index || third.index == child.index));
+    REQUIRE(store.IsValid(second));
+    REQUIRE(store.IsValid(third));
+    REQUIRE_FALSE(store.IsValid(first));
+    REQUIRE_FALSE(store.IsValid(child));
+
+    // Removing through a stale handle does nothing
+    store.Remove(first);
+    REQUIRE(store.Size() == 2);
+}
+
+TEST_CASE("NodeStore draws parents before children and siblings back to front", "[NodeStore]")
+{
+    NodeStore store;
+    auto a = store.Add(NRectf(0.0f, 0.0f, 100.0f, 100.0f));
+    auto b = store.Add(NRectf(200.0f, 0.0f, 100.0f, 100.0f));
+    auto a1 = store.Add(NRectf(10.0f, 10.0f, 20.0f, 20.0f), a);
+    auto a2 = store.Add(NRectf(40.0f, 10.0f, 20.0f, 20.0f), a);
+    auto a1x = store.Add(NRectf(12.0f, 12.0f, 5.0f, 5.0f), a1);
+
+    REQUIRE(handles_in_draw_order(store) == std::vector<NodeHandle>{ a, a1, a1x, a2, b });
+
+    // Raising moves the whole subtree in front of its siblings
+    store.Raise(a);
+    store.Raise(a1);
+    REQUIRE(handles_in_draw_order(store) == std::vector<NodeHandle>{ b, a, a2, a1, a1x });
+}
+
+TEST_CASE("NodeStore culling skips the children of nodes outside the view", "[NodeStore]")
+{
+    NodeStore store;
+    auto inside = store.Add(NRectf(0.0f, 0.0f, 100.0f, 100.0f));
+    auto insideChild = store.Add(NRectf(10.0f, 10.0f, 10.0f, 10.0f), inside);
+    auto outside = store.Add(NRectf(1000.0f, 1000.0f, 100.0f, 100.0f));
+
+    // This child overlaps the view, but its parent doesn't, so it goes with it
+    store.Add(NRectf(50.0f, 50.0f, 10.0f, 10.0f), outside);
+
+    std::vector<NodeHandle> visible;
+    store.Cull(NRectf(0.0f, 0.0f, 200.0f, 200.0f), visible);
+    REQUIRE(visible == std::vector<NodeHandle>{ inside, insideChild });
+}
+
+TEST_CASE("NodeStore hit tests the front most node, only inside its parent", "[NodeStore]")
+{
+    NodeStore store;
+    auto back = store.Add(NRectf(0.0f, 0.0f, 100.0f, 100.0f));
+    auto front = store.Add(NRectf(50.0f, 50.0f, 100.0f, 100.0f));
+    auto child = store.Add(NRectf(60.0f, 60.0f, 10.0f, 10.0f), front);
+    auto strayChild = store.Add(NRectf(500.0f, 500.0f, 10.0f, 10.0f), back);
+
+    REQUIRE(store.HitTest(glm::vec2(10.0f, 10.0f)) == back);
+    REQUIRE(store.HitTest(glm::vec2(75.0f, 75.0f)) == front);
+    REQUIRE(store.HitTest(glm::vec2(65.0f, 65.0f)) == child);
+
+    // Outside of its parent, a child can't be hit
+    REQUIRE_FALSE(store.IsValid(store.HitTest(glm::vec2(505.0f, 505.0f))));
+    REQUIRE(store.IsValid(strayChild));
+
+    store.Raise(back);
+    REQUIRE(store.HitTest(glm::vec2(75.0f, 75.0f)) == back);
+    REQUIRE_FALSE(store.IsValid(store.HitTest(glm::vec2(-5.0f, -5.0f))));
+}
+
+TEST_CASE("NodeStore moves nested selections once", "[NodeStore]")
+{
+    NodeStore store;
+    auto parent = store.Add(NRectf(0.0f, 0.0f, 100.0f, 100.0f));
+    auto child = store.Add(NRectf(10.0f, 10.0f, 10.0f, 10.0f), parent);
+    auto other = store.Add(NRectf(200.0f, 0.0f, 10.0f, 10.0f));
+
+    // The child is selected along with its parent; it should still only move once
+    std::vector<NodeHandle> selection{ child, parent };
+    store.Move(selection, glm::vec2(5.0f, -5.0f));
+
+    REQUIRE(store.GetRect(parent).topLeftPx == glm::vec2(5.0f, -5.0f));
+    REQUIRE(store.GetRect(parent).bottomRightPx == glm::vec2(105.0f, 95.0f));
+    REQUIRE(store.GetRect(child).topLeftPx == glm::vec2(15.0f, 5.0f));
+    REQUIRE(store.GetRect(other).topLeftPx == glm::vec2(200.0f, 0.0f));
+}
+
+TEST_CASE("NodeStore reads back what it writes", "[NodeStore]")
+{
+    NodeStore store;
+    auto a = store.Add(NRectf(0.0f, 0.0f, 100.0f, 100.0f));
+    store.Add(NRectf(200.0f, 0.0f, 50.0f, 60.0f));
+    auto a1 = store.Add(NRectf(10.0f, 10.0f, 20.0f, 20.0f), a);
+    store.SetFlags(a1, 0x1234);
+    store.Raise(a);
+
+    std::stringstream stream;
+    store.Write(stream);
+    auto written = stream.str();
+
+    NodeStore loaded;
+    REQUIRE(loaded.Read(stream));
+    REQUIRE(loaded.Size() == 3);
+
+    // Slots are renumbered on read, so compare in draw order
+    auto before = handles_in_draw_order(store);
+    auto after = handles_in_draw_order(loaded);
+    REQUIRE(after.size() == before.size());
+    for (size_t i = 0; i < before.size(); i++)
+    {
+        REQUIRE(loaded.GetRect(after[i]).topLeftPx == store.GetRect(before[i]).topLeftPx);
+        REQUIRE(loaded.GetRect(after[i]).bottomRightPx == store.GetRect(before[i]).bottomRightPx);
+        REQUIRE(loaded.GetFlags(after[i]) == store.GetFlags(before[i]));
+
+        auto parent = store.GetParent(before[i]);
+        auto loadedParent = loaded.GetParent(after[i]);
+        REQUIRE(store.IsValid(parent) == loaded.IsValid(loadedParent));
+        if (store.IsValid(parent))
+        {
+            REQUIRE(loaded.GetRect(loadedParent).topLeftPx == store.GetRect(parent).topLeftPx);
+        }
+    }
+
+    SECTION("Truncated")
+    {
+        std::stringstream truncated(written.substr(0, written.size() - 4));
+        NodeStore damaged;
+        REQUIRE_FALSE(damaged.Read(truncated));
+        REQUIRE(damaged.Size() == 0);
+    }
+
+    SECTION("Count larger than the stream")
+    {
+        auto corrupt = written;
+        uint32_t count = 0x7FFFFFFF;
+        corrupt.replace(8, sizeof(count), reinterpret_cast<const char*>(&count), sizeof(count));
+        std::stringstream in(corrupt);
+        NodeStore damaged;
+        REQUIRE_FALSE(damaged.Read(in));
+    }
+}
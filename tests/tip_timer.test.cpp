@@ -0,0 +1,48 @@
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <nodegraph/widgets/widget.h>
+
+#include "catch.hpp"
+
+using namespace NodeGraph;
+
+TEST_CASE("TipTimer redraws its owner when it decays to off", "[TipTimer]")
+{
+    TipScheduler scheduler;
+    Widget owner("Owner");
+    TipTimer tip(&owner, 0.0f, 0.01f, 0.01f);
+
+    tip.SetState(TipState::On, scheduler);
+    tip.Stop(scheduler);
+    REQUIRE(tip.GetState() == TipState::Decay);
+    REQUIRE(scheduler.GetActiveCount() == 1);
+
+    // Drawn with the last of the fade; nothing else will dirty the owner again
+    owner.ClearDirty();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    scheduler.Tick();
+
+    REQUIRE(tip.GetState() == TipState::Off);
+    REQUIRE(tip.Alpha() == 0.0f);
+    REQUIRE(scheduler.GetActiveCount() == 0);
+    REQUIRE_FALSE(scheduler.IsAnimating());
+    REQUIRE(owner.IsDirty());
+}
+
+TEST_CASE("TipTimer leaves the scheduler when its alpha reaches zero", "[TipTimer]")
+{
+    TipScheduler scheduler;
+    Widget owner("Owner");
+
+    // Much longer out than in, so that timing the decay against the fade in would end it early
+    TipTimer tip(&owner, 0.0f, 0.01f, 10.0f);
+    tip.SetState(TipState::On, scheduler);
+    tip.Stop(scheduler);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    scheduler.Tick();
+    REQUIRE(tip.GetState() == TipState::Decay);
+    REQUIRE(tip.Alpha() > 0.0f);
+}
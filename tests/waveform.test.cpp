@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <nodegraph/waveform.h>
+
+#include "catch.hpp"
+
+using namespace NodeGraph;
+
+namespace {
+
+std::vector<float> make_samples(size_t count)
+{
+    // A tone with noise on it, so that neighbouring bins differ
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.25f, 0.25f);
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        samples[i] = 0.7f * std::sin(float(i) * 0.013f) + noise(rng);
+    }
+    return samples;
+}
+
+struct Scan
+{
+    float minimum;
+    float maximum;
+    float rms;
+};
+
+Scan scan(const std::vector<float>& samples, size_t begin, size_t end)
+{
+    Scan result{ samples[begin], samples[begin], 0.0f };
+    double squares = 0.0;
+    for (auto i = begin; i < end; i++)
+    {
+        result.minimum = std::min(result.minimum, samples[i]);
+        result.maximum = std::max(result.maximum, samples[i]);
+        squares += double(samples[i]) * samples[i];
+    }
+    result.rms = float(std::sqrt(squares / double(end - begin)));
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Waveform appended in blocks matches one Set", "[Waveform]")
+{
+    auto samples = make_samples(10007);
+
+    Waveform whole;
+    whole.Set(samples);
+
+    // Uneven blocks, so appends land part way through bins at every level
+    Waveform streamed;
+    size_t blockSizes[] = { 1, 7, 16, 100, 333, 1024, 5 };
+    size_t offset = 0;
+    for (size_t block = 0; offset < samples.size(); block++)
+    {
+        auto count = std::min(blockSizes[block % std::size(blockSizes)], samples.size() - offset);
+        streamed.Append(std::span<const float>(samples.data() + offset, count));
+        offset += count;
+    }
+    REQUIRE(streamed.GetSampleCount() == whole.GetSampleCount());
+
+    // From a sample per column up to the whole buffer in one, so every level is read
+    std::vector<WaveformBin> expected;
+    std::vector<WaveformBin> actual;
+    for (uint32_t columns : { 10007u, 2000u, 625u, 157u, 40u, 9u, 1u })
+    {
+        whole.Summarize(0, samples.size(), columns, expected);
+        streamed.Summarize(0, samples.size(), columns, actual);
+        REQUIRE(actual.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            REQUIRE(actual[i].minimum == expected[i].minimum);
+            REQUIRE(actual[i].maximum == expected[i].maximum);
+            REQUIRE(actual[i].rms == expected[i].rms);
+        }
+    }
+}
+
+TEST_CASE("Waveform bins aligned to the pyramid match a scan of the samples", "[Waveform]")
+{
+    auto samples = make_samples(Waveform::BinSamples * 1024);
+
+    Waveform waveform;
+    waveform.Set(samples);
+
+    // Below a bin per column the samples are read directly; above it, whole bins from levels 0, 2, 4 and the top
+    std::vector<WaveformBin> bins;
+    for (uint32_t samplesPerColumn : { 4u, 16u, 64u, 256u, 16384u })
+    {
+        auto columns = uint32_t(samples.size() / samplesPerColumn);
+        waveform.Summarize(0, samples.size(), columns, bins);
+        REQUIRE(bins.size() == columns);
+        for (uint32_t column = 0; column < columns; column++)
+        {
+            auto expected = scan(samples, column * samplesPerColumn, (column + 1) * samplesPerColumn);
+            REQUIRE(bins[column].minimum == expected.minimum);
+            REQUIRE(bins[column].maximum == expected.maximum);
+            REQUIRE(bins[column].rms == Approx(expected.rms).epsilon(0.001));
+        }
+    }
+}
+
+TEST_CASE("Waveform bins in an unaligned view stay within a column of their samples", "[Waveform]")
+{
+    auto samples = make_samples(20011);
+
+    Waveform waveform;
+    waveform.Set(samples);
+
+    // A column reads whole bins, so it can see a little either side of its samples, but never more than a column
+    size_t begin = 37;
+    size_t end = samples.size() - 101;
+    std::vector<WaveformBin> bins;
+    for (uint32_t columns : { 3000u, 700u, 123u, 10u })
+    {
+        waveform.Summarize(begin, end, columns, bins);
+        auto samplesPerColumn = double(end - begin) / double(columns);
+        auto reach = size_t(std::ceil(samplesPerColumn));
+        for (uint32_t column = 0; column < columns; column++)
+        {
+            auto from = begin + size_t(double(column) * samplesPerColumn);
+            auto to = std::clamp(begin + size_t(double(column + 1) * samplesPerColumn), from + 1, end);
+            auto exact = scan(samples, from, to);
+            auto widest = scan(samples, from > reach ? from - reach : 0, std::min(to + reach, samples.size()));
+
+            REQUIRE(bins[column].minimum <= exact.minimum);
+            REQUIRE(bins[column].maximum >= exact.maximum);
+            REQUIRE(bins[column].minimum >= widest.minimum);
+            REQUIRE(bins[column].maximum <= widest.maximum);
+        }
+    }
+}
+
+TEST_CASE("Waveform clears and summarizes nothing when empty", "[Waveform]")
+{
+    Waveform waveform;
+    REQUIRE(waveform.Empty());
+
+    std::vector<WaveformBin> bins(4);
+    waveform.Summarize(0, 100, 4, bins);
+    REQUIRE(bins.empty());
+
+    auto samples = make_samples(100);
+    waveform.Set(samples);
+    REQUIRE(waveform.GetSampleCount() == 100);
+
+    waveform.Clear();
+    REQUIRE(waveform.Empty());
+}